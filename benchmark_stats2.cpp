@@ -1,16 +1,28 @@
 #include "RandomEllipsoidGenerator.hpp"
+#include "EllipsoidDataset.hpp"
 #include "KFromEllipsoids.hpp"
 #include "OptimalRadius.hpp"
+#include "FixedDim.hpp"
 
 #include "LPType.hpp"
 #include "LPSeidel.hpp"
 #include "LPClarkson.hpp"
+#include "PerfCounters.hpp"
 
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <cmath>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <numeric>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -38,6 +50,18 @@ struct RunningStats {
         M2 += delta * delta2;
     }
 
+    // Exact parallel combine (Chan et al.): *this becomes the stats of both sample sets
+    void merge(const RunningStats& o) {
+        if (o.n == 0) return;
+        if (n == 0) { *this = o; return; }
+        const double na = static_cast<double>(n), nb = static_cast<double>(o.n);
+        const double delta = o.mean - mean;
+        const int nab = n + o.n;
+        mean += delta * nb / static_cast<double>(nab);
+        M2 += o.M2 + delta * delta * na * nb / static_cast<double>(nab);
+        n = nab;
+    }
+
     int count() const { return n; }
 
     double variance() const {
@@ -49,6 +73,265 @@ struct RunningStats {
     }
 };
 
+// Methods timed per trial, in CSV row order
+enum Method {
+    RawSLSQP, RawPGD, RawCauchy,
+    LPSeidel, LPClarkson,
+    FixedSLSQP, FixedPGD, FixedCauchy, // only for d <= kMaxFixedDim
+    LPSeidelCold, LPClarksonCold,      // LP-type without warm-started inner solves
+    RawNewton, FixedNewton, LPSeidelNewton, // active-set projected Newton inner solver
+    RawPortfolio,                      // PGD, Cauchy, SLSQP and Newton raced
+    kNumMethods
+};
+
+const char* const kMethodNames[kNumMethods] = {
+    "Raw-SLSQP", "Raw-PGD", "Raw-Cauchy",
+    "LP-Seidel", "LP-Clarkson",
+    "Fixed-SLSQP", "Fixed-PGD", "Fixed-Cauchy",
+    "LP-Seidel-Cold", "LP-Clarkson-Cold",
+    "Raw-Newton", "Fixed-Newton", "LP-Seidel-Newton",
+    "Raw-Portfolio",
+};
+
+// One timed run of one method on one trial's instance
+struct Sample {
+    int trial = 0;
+    double ms = 0.0;
+    double iters = 0.0;  // raw: solver iterations; LP-type: summed over all inner solves
+    double eps = 0.0;    // the method's eps*
+    double dev = 0.0;    // eps - (median eps* of the trial's methods)
+    PerfCounters perf;   // counters of the timed run
+};
+
+// Latency and inner-solver iterations per method, plus every sample for percentiles
+// and the eps* cross-check
+struct MethodStat {
+    RunningStats ms;
+    RunningStats iters;
+    RunningStats eps;
+    std::vector<Sample> samples;
+    double max_abs_dev = 0.0;
+    int disagreements = 0; // trials with |dev| above the tolerance
+    PerfCounters perf;     // summed over trials
+
+    void push(const Sample& s, bool disagrees) {
+        ms.push(s.ms);
+        iters.push(s.iters);
+        eps.push(s.eps);
+        samples.push_back(s);
+        max_abs_dev = std::max(max_abs_dev, std::abs(s.dev));
+        disagreements += disagrees;
+        perf += s.perf;
+    }
+    void merge(const MethodStat& o) {
+        ms.merge(o.ms);
+        iters.merge(o.iters);
+        eps.merge(o.eps);
+        samples.insert(samples.end(), o.samples.begin(), o.samples.end());
+        max_abs_dev = std::max(max_abs_dev, o.max_abs_dev);
+        disagreements += o.disagreements;
+        perf += o.perf;
+    }
+};
+
+using MethodStats = std::array<MethodStat, kNumMethods>;
+
+// Linear interpolation between closest ranks; sorted must be ascending and nonempty
+static double percentile(const std::vector<double>& sorted, double p) {
+    const double pos = p * static_cast<double>(sorted.size() - 1);
+    const size_t lo = static_cast<size_t>(pos);
+    const size_t hi = std::min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (pos - static_cast<double>(lo)) * (sorted[hi] - sorted[lo]);
+}
+
+struct BenchConfig {
+    int warmup = 1;                 // untimed runs before each timed one
+    double eps_tol = 1e-5;          // |eps - median| / max(1, median) above this disagrees
+    std::array<bool, kNumMethods> enabled{};
+    std::string dump_dir;
+};
+
+struct Measured {
+    double ms = 0.0;
+    double iters = 0.0;
+    double eps = 0.0;
+    PerfCounters perf;
+};
+
+// cfg.warmup untimed runs, then one timed run. prep() builds per-run state outside the
+// timing (e.g. a fresh oracle, so no run profits from another's memo cache);
+// run(state) returns {iters, eps}.
+template <class Prep, class Run>
+static Measured measure(const BenchConfig& cfg, Prep&& prep, Run&& run) {
+    for (int w = 0; w < cfg.warmup; ++w) {
+        auto state = prep();
+        run(state);
+    }
+    auto state = prep();
+    std::pair<double, double> r;
+    const perf::Scope scope;
+    const double ms = time_ms([&]() { r = run(state); });
+    return {ms, r.first, r.second, scope.delta()};
+}
+
+// One random instance at (d, n), every enabled method timed once
+static void run_trial(int d, int n, int trial, unsigned long long seed, MethodStats& stats,
+                      const BenchConfig& cfg) {
+    // --- Generate random ellipsoids for this trial ---
+    RandomEllipsoidGenerator::Options opt;
+    opt.n = n;
+    opt.d = d;
+    opt.center_mode = RandomEllipsoidGenerator::CenterMode::UniformHypercube;
+    opt.center_scale = 1.0;
+    opt.spd_mode = RandomEllipsoidGenerator::SPDMode::LogUniformSpectrum;
+    opt.lambda_min = 0.25;
+    opt.lambda_max = 4.0;
+    opt.store_covariance = false; // directly store precision if you prefer
+    opt.radius = 1.;
+    opt.seed = static_cast<unsigned long>(seed);
+
+    RandomEllipsoidGenerator gen(opt);
+    auto Es = gen.generate();
+    if (!cfg.dump_dir.empty()) {
+        write_ellipsoid_dataset(cfg.dump_dir + "/d" + std::to_string(d) + "_n" + std::to_string(n) +
+                                "_s" + std::to_string(seed) + ".ellph", Es);
+    }
+
+    // Build objective for this instance
+    auto K = make_Kobjective_from_ellipsoids(1.0, Es);
+    std::vector<int> S(n);
+    std::iota(S.begin(), S.end(), 0);
+
+    std::array<std::optional<Measured>, kNumMethods> got;
+    auto none = []() { return 0; };
+
+    // --- Raw: solve once on the full set with each inner solver ---
+
+    auto raw = [&](Method m, SolverKind kind) {
+        if (!cfg.enabled[m]) return;
+        got[m] = measure(cfg, none, [&](int) {
+            auto res = optimal_radius(K, kind);
+            return std::pair<double, double>(res.iters, res.eps_star);
+        });
+    };
+    raw(RawSLSQP, SolverKind::SLSQP);
+    raw(RawPGD, SolverKind::PGD);
+    raw(RawCauchy, SolverKind::Cauchy);
+    raw(RawNewton, SolverKind::Newton);
+    raw(RawPortfolio, SolverKind::Portfolio);
+
+    // --- Fixed: the raw solves again with stack-allocated KObjectiveT<d> ---
+
+    if (d <= kMaxFixedDim) {
+        dispatch_dim(d, [&](auto dim) {
+            auto KF = make_Kobjective_from_ellipsoids<decltype(dim)::value>(1.0, Es);
+            auto fixed = [&](Method m, SolverKind kind) {
+                if (!cfg.enabled[m]) return;
+                got[m] = measure(cfg, none, [&](int) {
+                    auto res = optimal_radius(KF, kind);
+                    return std::pair<double, double>(res.iters, res.eps_star);
+                });
+            };
+            fixed(FixedSLSQP, SolverKind::SLSQP);
+            fixed(FixedPGD, SolverKind::PGD);
+            fixed(FixedCauchy, SolverKind::Cauchy);
+            fixed(FixedNewton, SolverKind::Newton);
+        });
+    }
+
+    // --- LP-type: Seidel + Clarkson (inner = SLSQP, or Newton for LP-Seidel-Newton) ---
+    // Each run gets a fresh oracle (built outside the timed region) so no method
+    // profits from another's memo cache; warm and cold differ only in warm_start.
+
+    auto oracle = [&](SolverKind inner, bool warm) {
+        return [&Es, d, inner, warm]() {
+            LPParams lp{inner, 1e-8};
+            lp.warm_start = warm;
+            return std::make_unique<EllipsoidLPOracle>(Es, d, lp);
+        };
+    };
+    auto seidel = [&](Method m, SolverKind inner, bool warm) {
+        if (!cfg.enabled[m]) return;
+        got[m] = measure(cfg, oracle(inner, warm), [&](const std::unique_ptr<EllipsoidLPOracle>& O) {
+            SeidelOptions so;
+            so.seed = 42;      // can also vary with trial if desired
+            so.max_depth = -1; // unlimited depth
+            const SeidelResult out = seidel_incremental(*O, S, so);
+            return std::pair<double, double>(O->inner_iterations(), out.basis.eps_star);
+        });
+    };
+    auto clarkson = [&](Method m, bool warm) {
+        if (!cfg.enabled[m]) return;
+        got[m] = measure(cfg, oracle(SolverKind::SLSQP, warm), [&](const std::unique_ptr<EllipsoidLPOracle>& O) {
+            ClarksonOptions co;
+            co.rounds = 25;
+            co.seed = 123;
+            const ClarksonResult out = clarkson_iterative(*O, S, co);
+            return std::pair<double, double>(O->inner_iterations(), out.basis.eps_star);
+        });
+    };
+    seidel(LPSeidel, SolverKind::SLSQP, true);
+    clarkson(LPClarkson, true);
+    seidel(LPSeidelCold, SolverKind::SLSQP, false);
+    clarkson(LPClarksonCold, false);
+    seidel(LPSeidelNewton, SolverKind::Newton, true);
+
+    // --- Cross-check: every method against the median eps* of this trial ---
+
+    std::vector<double> all;
+    for (const auto& g : got) if (g) all.push_back(g->eps);
+    if (all.empty()) return;
+    std::sort(all.begin(), all.end());
+    const double ref = percentile(all, 0.5);
+    const double scale = std::max(1.0, std::abs(ref));
+    for (int m = 0; m < kNumMethods; ++m) {
+        if (!got[m]) continue;
+        const Sample smp{trial, got[m]->ms, got[m]->iters, got[m]->eps, got[m]->eps - ref, got[m]->perf};
+        stats[m].push(smp, std::abs(smp.dev) > cfg.eps_tol * scale);
+    }
+}
+
+// Comma-separated integers, e.g. "2,3,10"
+static std::vector<int> parse_int_list(const std::string& s) {
+    std::vector<int> out;
+    std::stringstream ss(s);
+    std::string tok;
+    while (std::getline(ss, tok, ',')) {
+        if (!tok.empty()) out.push_back(std::stoi(tok));
+    }
+    if (out.empty()) throw std::invalid_argument("empty list: " + s);
+    return out;
+}
+
+// Comma-separated method names (as in the CSV), or "all"
+static std::array<bool, kNumMethods> parse_methods(const std::string& s) {
+    std::array<bool, kNumMethods> on{};
+    std::stringstream ss(s);
+    std::string tok;
+    while (std::getline(ss, tok, ',')) {
+        if (tok == "all") { on.fill(true); continue; }
+        int m = 0;
+        while (m < kNumMethods && tok != kMethodNames[m]) ++m;
+        if (m == kNumMethods) throw std::invalid_argument("unknown method: " + tok);
+        on[m] = true;
+    }
+    return on;
+}
+
+static void usage(const char* prog) {
+    std::cerr << "usage: " << prog << " [num_trials] [--threads N] [--pin] [--dump DIR] [--warmup N]\n"
+              << "       [--d LIST] [--n LIST] [--methods LIST] [--tol X] [--samples FILE]\n"
+              << "  --threads N     spread trials over N workers (default 1 = serial)\n"
+              << "  --pin           pin worker w to core w (Linux)\n"
+              << "  --dump DIR      write every generated instance to DIR as a v2 dataset file\n"
+              << "  --warmup N      untimed runs before each timed run (default 1)\n"
+              << "  --d LIST        dimensions, comma-separated (default 2,3,4,10,20,50)\n"
+              << "  --n LIST        ellipsoid counts, comma-separated (default 2,3,4)\n"
+              << "  --methods LIST  method names as in the CSV, comma-separated (default all)\n"
+              << "  --tol X         relative eps* disagreement tolerance (default 1e-5)\n"
+              << "  --samples FILE  also write every per-trial sample to FILE\n";
+}
+
 int main(int argc, char** argv) {
     std::cout.setf(std::ios::fixed);
     std::cout.precision(9);
@@ -56,15 +339,47 @@ int main(int argc, char** argv) {
     // Number of random instances per (n,d) per method.
     // You can override from the command line: ./prog 100
     int num_trials = 50;
-    if (argc >= 2) {
-        num_trials = std::stoi(argv[1]);
+    int num_threads = 1;
+    bool pin_threads = false;
+    BenchConfig cfg;
+    cfg.enabled.fill(true);
+    std::vector<int> d_values = {2, 3, 4, 10, 20, 50};
+    std::vector<int> n_values = {2, 3, 4};
+    std::string samples_path;
+    try {
+        for (int a = 1; a < argc; ++a) {
+            auto has_value = [&]() { return a + 1 < argc; };
+            if (std::strcmp(argv[a], "--threads") == 0 && has_value()) {
+                num_threads = std::stoi(argv[++a]);
+            } else if (std::strcmp(argv[a], "--pin") == 0) {
+                pin_threads = true;
+            } else if (std::strcmp(argv[a], "--dump") == 0 && has_value()) {
+                cfg.dump_dir = argv[++a];
+            } else if (std::strcmp(argv[a], "--warmup") == 0 && has_value()) {
+                cfg.warmup = std::max(0, std::stoi(argv[++a]));
+            } else if (std::strcmp(argv[a], "--d") == 0 && has_value()) {
+                d_values = parse_int_list(argv[++a]);
+            } else if (std::strcmp(argv[a], "--n") == 0 && has_value()) {
+                n_values = parse_int_list(argv[++a]);
+            } else if (std::strcmp(argv[a], "--methods") == 0 && has_value()) {
+                cfg.enabled = parse_methods(argv[++a]);
+            } else if (std::strcmp(argv[a], "--tol") == 0 && has_value()) {
+                cfg.eps_tol = std::stod(argv[++a]);
+            } else if (std::strcmp(argv[a], "--samples") == 0 && has_value()) {
+                samples_path = argv[++a];
+            } else if (argv[a][0] != '-') {
+                num_trials = std::stoi(argv[a]);
+            } else {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        usage(argv[0]);
+        return 1;
     }
 
-    // Grid in (n,d)
-    // TODO: consider making these command-line parameters as well
-    const int d_values[] = {2, 3, 4, 10, 20, 50};
-    const int n_values[] = {2, 3, 4};
-
     // Open CSV output
     const std::string filename = "benchmark_results.csv";
     std::ofstream ofs(filename);
@@ -72,131 +387,136 @@ int main(int argc, char** argv) {
         std::cerr << "Error: could not open " << filename << " for writing.\n";
         return 1;
     }
+    std::ofstream sfs;
+    if (!samples_path.empty()) {
+        sfs.open(samples_path);
+        if (!sfs) {
+            std::cerr << "Error: could not open " << samples_path << " for writing.\n";
+            return 1;
+        }
+        sfs << "d,n,trial,method,ms,iters,eps_star,eps_dev\n";
+        sfs.precision(12);
+    }
+
+    // Trials are independent; each worker keeps its own stats, merged after every (d,n)
+    std::unique_ptr<WorkStealingPool> pool;
+    if (num_threads > 1) {
+        pool = std::make_unique<WorkStealingPool>(WorkStealingPool::Options{num_threads, pin_threads});
+    }
 
     // CSV header
-    ofs << "d,n,method,mean_ms,std_ms,num_trials\n";
+    ofs << "d,n,method,mean_ms,std_ms,num_trials,mean_iters,"
+           "p50_ms,p90_ms,p99_ms,min_ms,max_ms,mean_eps,max_abs_eps_dev,num_disagree,"
+           "objective_evals,llt_factorizations,llt_failures,inner_solves,inner_converged,"
+           "cache_hits,cache_misses,basis_calls,solve_ms,basis_ms,scan_ms\n";
+    ofs.precision(9);
+
+    int total_disagree = 0;
 
     // Sweep over d, n
     for (int d : d_values) {
         for (int n : n_values) {
 
-            // Running stats for each of the 5 methods at this (n,d)
-            RunningStats stats_raw_slsqp;
-            RunningStats stats_raw_pgd;
-            RunningStats stats_raw_cauchy;
-            RunningStats stats_lp_seidel;
-            RunningStats stats_lp_clarkson;
-
-            // Base seed; perturbed by trial index to vary instances
+            // Base seed; perturbed by trial index to vary instances.
+            // Seeds depend only on (d, n, trial), so instances do not depend on the thread count.
             const unsigned long long base_seed = 12345ull
                                                  + 1000ull * static_cast<unsigned long long>(d)
                                                  + 10ull * static_cast<unsigned long long>(n);
 
-            for (int trial = 0; trial < num_trials; ++trial) {
-                // --- Generate random ellipsoids for this trial ---
-                RandomEllipsoidGenerator::Options opt;
-                opt.n = n;
-                opt.d = d;
-                opt.center_mode = RandomEllipsoidGenerator::CenterMode::UniformHypercube;
-                opt.center_scale = 1.0;
-                opt.spd_mode = RandomEllipsoidGenerator::SPDMode::LogUniformSpectrum;
-                opt.lambda_min = 0.25;
-                opt.lambda_max = 4.0;
-                opt.store_covariance = false; // directly store precision if you prefer
-                opt.radius = 1.;
-                opt.seed = static_cast<unsigned long>(
-                    base_seed + static_cast<unsigned long long>(trial)
-                );
-
-                RandomEllipsoidGenerator gen(opt);
-                auto Es = gen.generate();
-
-                // Build objective and LP oracle for this instance
-                auto K = make_Kobjective_from_ellipsoids(1.0, Es);
-                EllipsoidLPOracle O(Es, d, LPParams{SolverKind::SLSQP, 1e-8});
-                std::vector<int> S(n);
-                std::iota(S.begin(), S.end(), 0);
-
-                // --- Raw: solve once on full set with three inner solvers ---
-
-                {
-                    double eps_star = 0.0;
-                    double ms = time_ms([&]() {
-                        auto res = optimal_radius(K, SolverKind::SLSQP);
-                        eps_star = res.eps_star;
-                    });
-                    (void)eps_star; // eps_star is computed for sanity; unused here
-                    stats_raw_slsqp.push(ms);
-                }
-
-                {
-                    double eps_star = 0.0;
-                    double ms = time_ms([&]() {
-                        auto res = optimal_radius(K, SolverKind::PGD);
-                        eps_star = res.eps_star;
-                    });
-                    (void)eps_star;
-                    stats_raw_pgd.push(ms);
-                }
-
-                {
-                    double eps_star = 0.0;
-                    double ms = time_ms([&]() {
-                        auto res = optimal_radius(K, SolverKind::Cauchy);
-                        eps_star = res.eps_star;
-                    });
-                    (void)eps_star;
-                    stats_raw_cauchy.push(ms);
-                }
-
-                // --- LP-type: Seidel + Clarkson (inner = SLSQP here) ---
-
-                {
-                    SeidelOptions so;
-                    so.seed = 42;      // can also vary with trial if desired
-                    so.max_depth = -1; // unlimited depth
-
-                    SeidelResult out;
-                    double ms = time_ms([&]() {
-                        out = seidel_incremental(O, S, so);
-                    });
-                    (void)out; // could check out.basis.eps_star vs eps_star if desired
-                    stats_lp_seidel.push(ms);
+            MethodStats stats;
+            if (!pool) {
+                for (int trial = 0; trial < num_trials; ++trial) {
+                    run_trial(d, n, trial, base_seed + static_cast<unsigned long long>(trial), stats, cfg);
                 }
-
-                {
-                    ClarksonOptions co;
-                    co.rounds = 25;
-                    co.seed = 123;
-
-                    ClarksonResult out;
-                    double ms = time_ms([&]() {
-                        out = clarkson_iterative(O, S, co);
-                    });
-                    (void)out;
-                    stats_lp_clarkson.push(ms);
+            } else {
+                std::vector<MethodStats> per_worker(static_cast<size_t>(pool->size()));
+                pool->parallel_for(0, num_trials, [&](int trial) {
+                    run_trial(d, n, trial, base_seed + static_cast<unsigned long long>(trial),
+                              per_worker[WorkStealingPool::current_worker()], cfg);
+                });
+                for (const auto& ws : per_worker) {
+                    for (int m = 0; m < kNumMethods; ++m) stats[m].merge(ws[m]);
                 }
             }
 
             // Write one row per method for this (n,d)
-            auto write_row = [&](const std::string& method, const RunningStats& st) {
+            auto write_row = [&](const std::string& method, const MethodStat& st) {
+                std::vector<double> ms;
+                ms.reserve(st.samples.size());
+                for (const auto& smp : st.samples) ms.push_back(smp.ms);
+                std::sort(ms.begin(), ms.end());
                 ofs << d << ","
                     << n << ","
                     << method << ","
-                    << st.mean << ","
-                    << st.stddev() << ","
-                    << st.count() << "\n";
+                    << st.ms.mean << ","
+                    << st.ms.stddev() << ","
+                    << st.ms.count() << ","
+                    << st.iters.mean << ","
+                    << percentile(ms, 0.50) << ","
+                    << percentile(ms, 0.90) << ","
+                    << percentile(ms, 0.99) << ","
+                    << ms.front() << ","
+                    << ms.back() << ","
+                    << st.eps.mean << ","
+                    << st.max_abs_dev << ","
+                    << st.disagreements;
+                // Perf counters: means per trial
+                const double per = 1.0 / static_cast<double>(st.ms.count());
+                const PerfCounters& pc = st.perf;
+                const SolverPerf sp = pc.solver_total();
+                ofs << "," << pc.objective_evals * per
+                    << "," << pc.llt_factorizations * per
+                    << "," << pc.llt_failures * per
+                    << "," << sp.solves * per
+                    << "," << sp.converged * per
+                    << "," << pc.cache_hits * per
+                    << "," << pc.cache_misses * per
+                    << "," << pc.basis_calls * per
+                    << "," << pc.ms(PerfPhase::Solve) * per
+                    << "," << pc.ms(PerfPhase::Basis) * per
+                    << "," << pc.ms(PerfPhase::Scan) * per << "\n";
             };
 
-            write_row("Raw-SLSQP",    stats_raw_slsqp);
-            write_row("Raw-PGD",      stats_raw_pgd);
-            write_row("Raw-Cauchy",   stats_raw_cauchy);
-            write_row("LP-Seidel",    stats_lp_seidel);
-            write_row("LP-Clarkson",  stats_lp_clarkson);
+            for (int m = 0; m < kNumMethods; ++m) {
+                MethodStat& st = stats[m];
+                if (st.ms.count() == 0) continue;
+                write_row(kMethodNames[m], st);
+                if (st.disagreements > 0) {
+                    std::cerr << "eps* disagreement: d=" << d << " n=" << n << " " << kMethodNames[m]
+                              << " in " << st.disagreements << "/" << st.ms.count()
+                              << " trials, max |eps - median| = " << st.max_abs_dev << "\n";
+                    total_disagree += st.disagreements;
+                }
+                if (sfs.is_open()) {
+                    std::sort(st.samples.begin(), st.samples.end(),
+                              [](const Sample& a, const Sample& b) { return a.trial < b.trial; });
+                    for (const auto& smp : st.samples)
+                        sfs << d << "," << n << "," << smp.trial << "," << kMethodNames[m] << ","
+                            << smp.ms << "," << smp.iters << "," << smp.eps << "," << smp.dev << "\n";
+                }
+            }
         }
     }
 
     ofs.close();
     std::cerr << "Wrote CSV to " << filename << "\n";
+
+    // Portfolio wins per (k bucket, d), for choosing a default solver per bucket
+    const auto wins = portfolio_stats().snapshot();
+    if (!wins.empty()) {
+        const std::string wins_path = "portfolio_wins.csv";
+        std::ofstream wfs(wins_path);
+        wfs << "k_bucket,d,races,uncertified,wins_PGD,wins_Cauchy,wins_SLSQP,wins_Newton,best\n";
+        const char* const names[kNumSolverKinds] = {"PGD", "Cauchy", "SLSQP", "Newton"};
+        for (const auto& [key, b] : wins) {
+            wfs << key.first << "," << key.second << "," << b.races << "," << b.uncertified;
+            for (long long w : b.wins) wfs << "," << w;
+            wfs << "," << names[static_cast<int>(portfolio_stats().best(key.first, key.second))] << "\n";
+        }
+        std::cerr << "Wrote portfolio wins to " << wins_path << "\n";
+    }
+    if (sfs.is_open()) std::cerr << "Wrote samples to " << samples_path << "\n";
+    if (total_disagree > 0)
+        std::cerr << total_disagree << " method-trial eps* disagreements above tol " << cfg.eps_tol << "\n";
     return 0;
 }
@@ -0,0 +1,45 @@
+#pragma once
+#include "Ellipsoid.hpp"
+#include "EllipsoidSet.hpp"
+#include "LPClarkson.hpp"
+#include "LPSeidel.hpp"
+#include "OptimalRadius.hpp"
+#include "ThreadPool.hpp"
+#include <span>
+#include <vector>
+
+// One independent intersection problem, held by reference: an EllipsoidSet when set is
+// non-null, otherwise the ellipsoids span (all of one dimension).
+struct BatchInstance {
+    std::span<const Ellipsoid> ellipsoids;
+    const EllipsoidSet* set = nullptr;
+    double epsilon = 1.0; // K's ε; eps* does not depend on it
+
+    int k() const noexcept { return set ? set->size() : static_cast<int>(ellipsoids.size()); }
+    int d() const noexcept { return set ? set->d() : (ellipsoids.empty() ? 0 : ellipsoids[0].dim()); }
+};
+
+struct BatchOptions {
+    // Pool the instances run on. Null: a process-wide pool of hardware_concurrency()
+    // workers, created on first use and kept. Several threads may run batches on one
+    // pool at once; must not be called from a task of the pool it runs on.
+    WorkStealingPool* pool = nullptr;
+    bool bucket = true; // run instances grouped by (d, k), so each worker's scratch stays sized
+    int grain = 0;      // instances per task; <= 0: about 8 tasks per worker
+};
+
+// Solves every instance with `solver`; out[i] belongs to instances[i]. Each worker keeps
+// one objective workspace per dimension kind and gather buffers for ellipsoid spans, so
+// once they cover the largest (d, k) the objectives themselves do not allocate. Throws
+// std::invalid_argument for an empty instance or mixed dimensions within one.
+std::vector<EpsStar> optimal_radius_batch(std::span<const BatchInstance> instances,
+                                          SolverKind solver, const BatchOptions& opt = {});
+
+// LP-type equivalents: one oracle per instance over all of its ellipsoids. The per-call
+// drivers run serially inside each task (ClarksonOptions::threads and ::pool are ignored).
+std::vector<SeidelResult> seidel_batch(std::span<const BatchInstance> instances,
+                                       const LPParams& params, const SeidelOptions& so = {},
+                                       const BatchOptions& opt = {});
+std::vector<ClarksonResult> clarkson_batch(std::span<const BatchInstance> instances,
+                                           const LPParams& params, const ClarksonOptions& co = {},
+                                           const BatchOptions& opt = {});
@@ -1,5 +1,6 @@
 #pragma once
 #include "KObjective.hpp"
+#include <atomic>
 
 struct CSOptions {
     int max_iters = 4000;
@@ -10,6 +11,13 @@ struct CSOptions {
     bool armijo = true;        // Armijo line-search inside [0, eta_max - eps]
     double armijo_beta = 0.5;
     double armijo_c = 1e-4;
+    // A stop is trusted only when the Frank-Wolfe gap w·g - min_i g_i, over every
+    // coordinate, is at most gap_tol · max(1, |min_i g_i|). A weight clipped to zero cannot
+    // regrow multiplicatively, so otherwise a Frank-Wolfe step moves mass to argmin_i g_i
+    // and the iteration resumes, at most max_reseeds times.
+    double gap_tol = 1e-8;
+    int max_reseeds = 8;
+    const std::atomic<bool>* cancel = nullptr; // polled once per iteration; stops unconverged when set
 };
 
 struct CSResult {
@@ -19,6 +27,8 @@ struct CSResult {
     bool converged;
 };
 
-CSResult minimize_cauchy_simplex(KObjective& obj,
+// Obj is any KObjectiveT<D> (instantiated for ELLPH_FOR_EACH_DIM)
+template <class Obj>
+CSResult minimize_cauchy_simplex(Obj& obj,
                                  const Eigen::VectorXd& w0,
                                  const CSOptions& opt);
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+#include "Ellipsoid.hpp"
+#include "EllipsoidSet.hpp"
+#include "LPType.hpp"
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// A changing ellipsoid collection with its minimal common radius kept current.
+//
+// The LP-type basis and its evaluation (centroid m, eps*) are kept between updates.
+// insert() costs one violation test of the newcomer against (m, eps*); only a violator
+// triggers a re-solve. erase() re-solves only when the removed ellipsoid is in the basis.
+// A re-solve runs seidel_incremental over the live set with the surviving basis first and
+// the rest in fresh random order, so most of it is one scan. Since a basis has at most
+// d+1 elements, an update in a random arrival / expiry order re-solves with probability
+// at most (d+1)/size: the expected amortized cost per update is O(d) violation tests.
+// Each re-solve binds a new oracle to the slot arena, which is O(1) only without the
+// oracle's per-ellipsoid precomputations, so Options::lp must leave spatial_index and
+// float_scan off (the constructor throws std::invalid_argument otherwise).
+class DynamicIntersection {
+public:
+    using Id = std::int64_t;
+
+    struct Options {
+        LPParams lp{SolverKind::Newton, 1e-8}; // oracle parameters of every re-solve
+        std::uint64_t seed = 1;                // re-solve orders
+    };
+
+    struct Stats {
+        long long inserts = 0;
+        long long erases = 0;
+        long long violation_tests = 0; // insert tests plus those of every re-solve
+        long long resolves = 0;
+    };
+
+    explicit DynamicIntersection(int d);
+    DynamicIntersection(int d, Options opt);
+
+    // Returns the id of the new ellipsoid; throws std::invalid_argument on a dimension
+    // mismatch or a precision that is not SPD
+    Id insert(const Ellipsoid& E);
+    Id insert(const Eigen::Ref<const Eigen::VectorXd>& center,
+              const Eigen::Ref<const Eigen::MatrixXd>& precision, double radius = 1.0);
+
+    // false when id is not (or no longer) present
+    bool erase(Id id);
+
+    bool contains(Id id) const { return slot_of_.count(id) != 0; }
+    int size() const noexcept { return static_cast<int>(live_.size()); }
+    int d() const noexcept { return set_.d(); }
+
+    // Current optimum: eps* (0 when empty), the centroid m(λ*), and the basis ids
+    double eps_star() const noexcept { return ev_.eps_star; }
+    const Eigen::VectorXd& centroid() const noexcept { return ev_.m; }
+    std::vector<Id> basis() const;
+
+    const Stats& stats() const noexcept { return stats_; }
+
+private:
+    Options opt_;
+    EllipsoidSet set_;                    // slot storage; slots of erased ids are reused
+    std::vector<Id> slot_id_;             // id in each slot, -1 when free
+    std::vector<int> free_;               // free slots
+    std::vector<int> live_;               // occupied slots, any order
+    std::vector<int> live_pos_;           // slot -> position in live_
+    std::unordered_map<Id, int> slot_of_; // id -> slot
+    Id next_id_ = 0;
+
+    std::vector<int> basis_;              // slots
+    LPEval ev_;                           // evaluation of basis_
+    std::mt19937_64 rng_;
+    Stats stats_;
+    mutable Eigen::VectorXd diff_;        // violates() scratch
+
+    int take_slot(const Eigen::Ref<const Eigen::VectorXd>& center,
+                  const Eigen::Ref<const Eigen::MatrixXd>& precision, double radius);
+    bool violates(int slot) const;
+    void resolve(std::vector<int> front); // front: slots to place first in the order
+};
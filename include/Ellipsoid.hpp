@@ -1,5 +1,7 @@
 #pragma once
 #include <Eigen/Dense>
+#include <memory>
+#include <mutex>
 #include <optional>
 
 class Ellipsoid {
@@ -18,15 +20,47 @@ public:
     double radius() const noexcept { return radius_; }
 
     // Guaranteed SPD (throws std::runtime_error if inversion fails, which shouldn't happen if SPD)
+    // Derived quantities are computed once and are safe to request from several threads.
     const Mat& covariance() const;
     const Mat& precision()  const;
 
+    // Lower Cholesky factor L of the precision: A^{-1} = L L^T
+    const Mat& precision_factor() const;
+
+    // Squared Mahalanobis distance (x-c)^T A^{-1} (x-c) = ||L^T (x-c)||^2 (triangular product)
+    double mahalanobis2(const Eigen::Ref<const Vec>& x) const;
+
     // Dimension
     int dim() const noexcept { return static_cast<int>(center_.size()); }
 
 private:
+    // Lazily derived data. Shared between copies: an Ellipsoid is immutable after
+    // construction, so whatever one copy computes is valid for all of them.
+    struct Derived {
+        std::once_flag cov_once, prec_once, factor_once;
+        Mat cov;    // Σ, if only the precision was given
+        Mat prec;   // A^{-1}, if only the covariance was given
+        Mat L;      // chol(A^{-1})
+    };
+
     Vec center_;
-    mutable std::optional<Mat> cov_;   // Σ
-    mutable std::optional<Mat> prec_;  // A^{-1}
+    std::optional<Mat> cov_;   // Σ as given
+    std::optional<Mat> prec_;  // A^{-1} as given
     double radius_{1.0};
-};
\ No newline at end of file
+    std::shared_ptr<Derived> derived_;
+};
+
+// ||L^T (m - c)||^2 for a lower factor L. (L^T diff)_c only touches the lower part of
+// column c, which is contiguous, so each dot vectorizes at half the flops of A^{-1} diff.
+template <class LMat, class CVec>
+inline double mahalanobis2_lower(const LMat& L, const CVec& c,
+                                 const Eigen::VectorXd& m, Eigen::VectorXd& diff) {
+    const int d = static_cast<int>(m.size());
+    diff.noalias() = m - c;
+    double d2 = 0.0;
+    for (int k = 0; k < d; ++k) {
+        const double t = L.col(k).tail(d - k).dot(diff.tail(d - k));
+        d2 += t * t;
+    }
+    return d2;
+}
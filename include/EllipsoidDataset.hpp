@@ -0,0 +1,111 @@
+#pragma once
+#include "Ellipsoid.hpp"
+#include <Eigen/Dense>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary ellipsoid dataset, format v2 (memory-mappable), the project's on-disk format.
+// Mapped whole by EllipsoidDataset, streamed section by section by FileEllipsoidSource.
+//   header   128 bytes, below
+//   centers  n × center_stride doubles, each center 64-byte aligned (stride padded to 8)
+//   blocks   n × block_stride doubles, 64-byte aligned: A^{-1} or its lower Cholesky
+//            factor L, full column-major d×d or packed (lower triangle, column by column)
+//   radii    n doubles
+// All section offsets are multiples of 64 bytes. Native byte order.
+enum EllipsoidLayout : std::uint32_t {
+    kLayoutFactor = 1u << 0, // blocks hold L (A^{-1} = L L^T), else A^{-1}
+    kLayoutPacked = 1u << 1, // d(d+1)/2 doubles per block, else d*d
+};
+
+struct EllipsoidDatasetHeader {
+    char magic[8];
+    std::uint32_t version;        // 2
+    std::uint32_t d;
+    std::uint64_t n;
+    std::uint32_t layout;         // EllipsoidLayout bits
+    std::uint32_t reserved0;
+    std::uint64_t center_stride;  // doubles
+    std::uint64_t block_stride;   // doubles
+    std::uint64_t centers_offset; // bytes from file start
+    std::uint64_t blocks_offset;
+    std::uint64_t radii_offset;
+    std::uint64_t reserved[7];
+};
+static_assert(sizeof(EllipsoidDatasetHeader) == 128);
+
+inline constexpr char kEllipsoidFileMagic[8] = {'E','L','L','P','H','D','S','\0'};
+
+// Throws std::runtime_error unless h is a valid v2 header for a file of file_bytes bytes
+void check_dataset_header(const EllipsoidDatasetHeader& h, std::uint64_t file_bytes,
+                          const std::string& path);
+
+// Writes Es in format v2. Default layout: full d×d Cholesky factors, the blocks the oracle
+// and the objective read in place. kLayoutPacked nearly halves the blocks, but readers
+// then unpack them into a copy.
+void write_ellipsoid_dataset(const std::string& path, const std::vector<Ellipsoid>& Es,
+                             std::uint32_t layout = kLayoutFactor);
+
+// One ellipsoid of a mapped dataset; valid while the dataset is
+class EllipsoidView {
+public:
+    EllipsoidView(const double* center, const double* block, double radius, int d, std::uint32_t layout)
+    : center_(center), block_(block), radius_(radius), d_(d), layout_(layout) {}
+
+    Eigen::Map<const Eigen::VectorXd> center() const { return {center_, d_}; }
+    double radius() const noexcept { return radius_; }
+    int dim() const noexcept { return d_; }
+    std::uint32_t layout() const noexcept { return layout_; }
+
+    // The stored block in place; only for unpacked layouts
+    Eigen::Map<const Eigen::MatrixXd> block() const;
+
+    // Lower Cholesky factor of the precision / the precision itself, into a d×d matrix
+    void precision_factor(Eigen::Ref<Eigen::MatrixXd> L) const;
+    void precision(Eigen::Ref<Eigen::MatrixXd> P) const;
+
+    // Owning copy
+    Ellipsoid to_ellipsoid() const;
+
+private:
+    const double* center_;
+    const double* block_;
+    double radius_;
+    int d_;
+    std::uint32_t layout_;
+};
+
+// Read-only mmap of a v2 file. Move-only; unmapped on destruction.
+class EllipsoidDataset {
+public:
+    explicit EllipsoidDataset(const std::string& path);
+    ~EllipsoidDataset();
+    EllipsoidDataset(EllipsoidDataset&& o) noexcept;
+    EllipsoidDataset& operator=(EllipsoidDataset&& o) noexcept;
+    EllipsoidDataset(const EllipsoidDataset&) = delete;
+    EllipsoidDataset& operator=(const EllipsoidDataset&) = delete;
+
+    int n() const noexcept { return static_cast<int>(hdr_->n); }
+    int d() const noexcept { return static_cast<int>(hdr_->d); }
+    std::uint32_t layout() const noexcept { return hdr_->layout; }
+
+    EllipsoidView operator[](int i) const {
+        return {centers_ + static_cast<size_t>(i) * hdr_->center_stride,
+                blocks_ + static_cast<size_t>(i) * hdr_->block_stride,
+                radii_[i], d(), hdr_->layout};
+    }
+
+    // Raw sections, for kernels that stream the whole set
+    const double* centers_data() const noexcept { return centers_; }
+    const double* blocks_data() const noexcept { return blocks_; }
+    size_t center_stride() const noexcept { return hdr_->center_stride; }
+    size_t block_stride() const noexcept { return hdr_->block_stride; }
+
+private:
+    void* base_ = nullptr;
+    size_t bytes_ = 0;
+    const EllipsoidDatasetHeader* hdr_ = nullptr;
+    const double* centers_ = nullptr;
+    const double* blocks_ = nullptr;
+    const double* radii_ = nullptr;
+};
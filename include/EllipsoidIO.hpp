@@ -0,0 +1,14 @@
+#pragma once
+#include "Ellipsoid.hpp"
+#include "EllipsoidDataset.hpp"
+#include <string>
+#include <vector>
+
+// Whole-set I/O in the dataset format (EllipsoidDataset.hpp)
+
+// write_ellipsoid_dataset with the default layout
+void write_ellipsoids(const std::string& path, const std::vector<Ellipsoid>& Es);
+
+// Whole file into memory (small sets; large ones go through EllipsoidDataset or
+// FileEllipsoidSource)
+std::vector<Ellipsoid> read_ellipsoids(const std::string& path);
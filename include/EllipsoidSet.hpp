@@ -0,0 +1,90 @@
+#pragma once
+#include "Ellipsoid.hpp"
+#include <Eigen/Dense>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class EllipsoidDataset;
+
+// Structure-of-arrays ellipsoid collection in one 64-byte-aligned arena.
+// Per index i: center x_i, precision A_i^{-1}, its lower Cholesky factor L_i,
+// A_i^{-1} x_i, q_i = x_i^T A_i^{-1} x_i and the radius. Every vector / matrix slot
+// starts on a 64-byte boundary (strides padded to 8 doubles); matrices are column-major.
+class EllipsoidSet {
+public:
+    using Vec = Eigen::VectorXd;
+    using Mat = Eigen::MatrixXd;
+
+    EllipsoidSet() = default;
+    explicit EllipsoidSet(int d, int capacity = 0);
+    explicit EllipsoidSet(const std::vector<Ellipsoid>& Es);
+    explicit EllipsoidSet(const EllipsoidDataset& ds);
+
+    EllipsoidSet(const EllipsoidSet& o);
+    EllipsoidSet& operator=(const EllipsoidSet& o);
+    EllipsoidSet(EllipsoidSet&&) noexcept = default;
+    EllipsoidSet& operator=(EllipsoidSet&&) noexcept = default;
+
+    int size() const noexcept { return n_; }
+    int d() const noexcept { return d_; }
+    bool empty() const noexcept { return n_ == 0; }
+
+    void reserve(int capacity);
+
+    // Append from a precision A^{-1} (SPD; factored here). Throws std::invalid_argument if
+    // the dimension is wrong or the precision is not SPD.
+    void push_back(const Eigen::Ref<const Vec>& center, const Eigen::Ref<const Mat>& precision,
+                   double radius = 1.0);
+    void push_back(const Ellipsoid& E);
+
+    // Grow to n slots; the new ones hold garbage until assign()ed. assign(i, ...) writes
+    // slot i like push_back does, and calls for distinct i may run concurrently.
+    void resize(int n);
+    void assign(int i, const Eigen::Ref<const Vec>& center, const Eigen::Ref<const Mat>& precision,
+                double radius = 1.0);
+
+    Eigen::Map<const Vec> center(int i) const { return {slot(kCenter, i), d_}; }
+    Eigen::Map<const Mat> precision(int i) const { return {slot(kPrecision, i), d_, d_}; }
+    Eigen::Map<const Mat> precision_factor(int i) const { return {slot(kFactor, i), d_, d_}; }
+    Eigen::Map<const Vec> precision_center(int i) const { return {slot(kAx, i), d_}; } // A_i^{-1} x_i
+    double q(int i) const { return scalars_[2 * static_cast<size_t>(i)]; }               // x_i^T A_i^{-1} x_i
+    double radius(int i) const { return scalars_[2 * static_cast<size_t>(i) + 1]; }
+
+    // Raw sections for streaming kernels: item i of field f at data(f) + i·stride(f)
+    const double* centers_data() const noexcept { return base(kCenter); }
+    const double* factors_data() const noexcept { return base(kFactor); }
+    const double* precisions_data() const noexcept { return base(kPrecision); }
+    const double* precision_centers_data() const noexcept { return base(kAx); }
+    const double* q_data() const noexcept { return scalars_.data(); } // stride q_stride()
+    size_t vec_stride() const noexcept { return vs_; }
+    size_t mat_stride() const noexcept { return ms_; }
+    static constexpr size_t q_stride() noexcept { return 2; }
+
+    Ellipsoid to_ellipsoid(int i) const;
+
+private:
+    enum Field { kCenter, kAx, kPrecision, kFactor, kNumFields };
+
+    struct Free { void operator()(double* p) const noexcept; };
+
+    int d_ = 0;
+    int n_ = 0;
+    int cap_ = 0;
+    size_t vs_ = 0; // doubles per vector slot
+    size_t ms_ = 0; // doubles per matrix slot
+    std::unique_ptr<double[], Free> arena_;
+    std::vector<double> scalars_; // (q_i, radius_i) pairs
+
+    size_t field_offset(Field f, int cap) const noexcept;
+    const double* base(Field f) const noexcept { return arena_.get() + field_offset(f, cap_); }
+    double* base(Field f) noexcept { return arena_.get() + field_offset(f, cap_); }
+    const double* slot(Field f, int i) const noexcept {
+        return base(f) + static_cast<size_t>(i) * (f == kCenter || f == kAx ? vs_ : ms_);
+    }
+    double* slot(Field f, int i) noexcept {
+        return base(f) + static_cast<size_t>(i) * (f == kCenter || f == kAx ? vs_ : ms_);
+    }
+    void regrow(int capacity);
+    double fill(int i, const Eigen::Ref<const Vec>& center, const Eigen::Ref<const Mat>& precision); // -> q_i
+};
@@ -0,0 +1,83 @@
+#pragma once
+#include "Ellipsoid.hpp"
+#include "EllipsoidDataset.hpp"
+#include <Eigen/Dense>
+#include <fstream>
+#include <future>
+#include <string>
+#include <vector>
+
+// Consecutive ellipsoids in the oracle's packed layout
+struct EllipsoidChunk {
+    long long first = 0;     // global index of column 0
+    int count = 0;           // valid columns / blocks
+    Eigen::MatrixXd centers; // d × capacity, column j = c_{first+j}
+    Eigen::MatrixXd factors; // d × (d·capacity), block j = L with A^{-1} = L L^T (lower)
+};
+
+// Sequential, chunked access to an ellipsoid collection that need not fit in memory.
+// A pass is begin_pass() followed by next() until it returns false.
+class EllipsoidSource {
+public:
+    virtual ~EllipsoidSource() = default;
+
+    virtual int d() const = 0;
+    virtual long long size() const = 0;
+
+    virtual void begin_pass() = 0;
+    // Next chunk of the pass; *out stays valid until the following call
+    virtual bool next(const EllipsoidChunk*& out) = 0;
+
+    // Random access, for the few ellipsoids a Clarkson sample needs
+    virtual Ellipsoid fetch(long long i) = 0;
+};
+
+// Chunks over a resident std::vector<Ellipsoid> (held by reference)
+class MemoryEllipsoidSource : public EllipsoidSource {
+public:
+    explicit MemoryEllipsoidSource(const std::vector<Ellipsoid>& all, int chunk_size = 4096);
+
+    int d() const override { return d_; }
+    long long size() const override { return static_cast<long long>(all_.size()); }
+    void begin_pass() override { pos_ = 0; }
+    bool next(const EllipsoidChunk*& out) override;
+    Ellipsoid fetch(long long i) override { return all_.at(static_cast<size_t>(i)); }
+
+private:
+    const std::vector<Ellipsoid>& all_;
+    int d_;
+    int chunk_size_;
+    long long pos_ = 0;
+    EllipsoidChunk buf_;
+};
+
+// Chunks read from a dataset file (EllipsoidDataset.hpp) with two bounded buffers: a
+// chunk is its slice of the centers and blocks sections, and while the caller tests one
+// chunk, the next is read (and its blocks turned into factors) on a background task
+class FileEllipsoidSource : public EllipsoidSource {
+public:
+    explicit FileEllipsoidSource(const std::string& path, int chunk_size = 4096);
+    ~FileEllipsoidSource() override;
+
+    int d() const override { return static_cast<int>(hdr_.d); }
+    long long size() const override { return static_cast<long long>(hdr_.n); }
+    void begin_pass() override;
+    bool next(const EllipsoidChunk*& out) override;
+    Ellipsoid fetch(long long i) override;
+
+private:
+    std::string path_;
+    std::ifstream scan_;   // sequential reads, owned by the prefetch task while it runs
+    std::ifstream random_; // fetch()
+    EllipsoidDatasetHeader hdr_{};
+    int chunk_size_;
+
+    EllipsoidChunk buf_[2];
+    std::vector<double> staging_[2]; // raw centers, then raw blocks, of the chunk being read
+    int reading_ = 0;                // buffer the pending task fills
+    std::future<void> pending_;
+
+    void read_chunk(int b, long long first); // blocking, into buf_[b]
+    void start_read(int b, long long first);
+    void drain();                            // wait for (and discard) a pending read
+};
@@ -0,0 +1,30 @@
+#pragma once
+#include <Eigen/Core>
+#include <type_traits>
+
+// Small dimensions get stack-allocated, fixed-size Eigen kernels.
+// Override with -DELLPH_MAX_FIXED_DIM=<0..4>; 0 or 1 disables the fixed path.
+#ifndef ELLPH_MAX_FIXED_DIM
+#define ELLPH_MAX_FIXED_DIM 4
+#endif
+
+inline constexpr int kMaxFixedDim = ELLPH_MAX_FIXED_DIM;
+static_assert(kMaxFixedDim <= 4, "only d in {2,3,4} have fixed-size instantiations");
+
+// Every dimension the templated objective / solvers are explicitly instantiated for
+#define ELLPH_FOR_EACH_DIM(X) X(Eigen::Dynamic) X(2) X(3) X(4)
+
+template <int D>
+using DimTag = std::integral_constant<int, D>;
+
+// Call f(DimTag<d>{}) when d has a fixed-size instantiation, f(DimTag<Eigen::Dynamic>{}) otherwise
+template <class F>
+decltype(auto) dispatch_dim(int d, F&& f) {
+    switch (d) {
+        case 2: if constexpr (kMaxFixedDim >= 2) return f(DimTag<2>{}); break;
+        case 3: if constexpr (kMaxFixedDim >= 3) return f(DimTag<3>{}); break;
+        case 4: if constexpr (kMaxFixedDim >= 4) return f(DimTag<4>{}); break;
+        default: break;
+    }
+    return f(DimTag<Eigen::Dynamic>{});
+}
@@ -1,17 +1,65 @@
 #pragma once
 #include "Ellipsoid.hpp"
+#include "EllipsoidDataset.hpp"
+#include "EllipsoidSet.hpp"
 #include "KObjective.hpp"
 #include <vector>
 
-inline KObjective make_Kobjective_from_ellipsoids(
+// D selects the fixed-size objective (see FixedDim.hpp); Es must then all have dim() == D
+template <int D = Eigen::Dynamic>
+inline KObjectiveT<D> make_Kobjective_from_ellipsoids(
         double epsilon,
         const std::vector<Ellipsoid>& Es)
 {
-    std::vector<KObjective::Vec> xs; xs.reserve(Es.size());
-    std::vector<KObjective::Mat> Ainv; Ainv.reserve(Es.size());
+    std::vector<Eigen::VectorXd> xs; xs.reserve(Es.size());
+    std::vector<Eigen::MatrixXd> Ainv; Ainv.reserve(Es.size());
+    std::vector<Eigen::MatrixXd> Ls; Ls.reserve(Es.size());
     for (const auto& E : Es) {
         xs.push_back(E.center());
         Ainv.push_back(E.precision()); // you guaranteed SPD precision
+        Ls.push_back(E.precision_factor()); // computed once per ellipsoid, not per objective
     }
-    return KObjective(epsilon, xs, Ainv);
-}
\ No newline at end of file
+    return KObjectiveT<D>(epsilon, xs, Ainv, Ls);
+}
+
+// Same from a mapped dataset. Centers and full blocks (factors or precisions) are read in
+// place, so ds must outlive the objective; packed blocks are unpacked into copies.
+template <int D = Eigen::Dynamic>
+inline KObjectiveT<D> make_Kobjective_from_ellipsoids(
+        double epsilon,
+        const EllipsoidDataset& ds)
+{
+    if (!(ds.layout() & kLayoutPacked)) {
+        KSource src;
+        src.n = ds.n();
+        src.d = ds.d();
+        src.centers = ds.centers_data(); src.center_stride = ds.center_stride();
+        if (ds.layout() & kLayoutFactor) {
+            src.factors = ds.blocks_data(); src.factor_stride = ds.block_stride();
+        } else {
+            src.precisions = ds.blocks_data(); src.precision_stride = ds.block_stride();
+        }
+        return KObjectiveT<D>(epsilon, src);
+    }
+    const int n = ds.n(), d = ds.d();
+    std::vector<Eigen::VectorXd> xs; xs.reserve(n);
+    std::vector<Eigen::MatrixXd> Ainv; Ainv.reserve(n);
+    std::vector<Eigen::MatrixXd> Ls; Ls.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        const EllipsoidView v = ds[i];
+        xs.emplace_back(v.center());
+        Ls.emplace_back(d, d);
+        v.precision_factor(Ls.back());
+        Ainv.emplace_back(Ls.back() * Ls.back().transpose());
+    }
+    return KObjectiveT<D>(epsilon, xs, Ainv, Ls);
+}
+
+// Same from an EllipsoidSet; factors and A^{-1}x, x^T A^{-1} x come from its arena
+template <int D = Eigen::Dynamic>
+inline KObjectiveT<D> make_Kobjective_from_ellipsoids(
+        double epsilon,
+        const EllipsoidSet& set)
+{
+    return KObjectiveT<D>(epsilon, set);
+}
@@ -1,20 +1,90 @@
 #pragma once
+#include "FixedDim.hpp"
 #include <Eigen/Dense>
+#include <memory>
+#include <span>
+#include <utility>
 #include <vector>
 
+class EllipsoidSet;
+
+// Per-index data an objective reads in place: item i of a field starts at ptr + i·stride
+// (matrices d×d column-major). Centers are required, and factors or precisions; a missing
+// field among factors / precisions / Ax / q is derived, for the selected indices only,
+// into the objective's workspace.
+struct KSource {
+    int n = 0, d = 0;
+    const double* centers = nullptr;    size_t center_stride = 0;
+    const double* factors = nullptr;    size_t factor_stride = 0;    // lower L_i, A_i^{-1} = L_i L_i^T
+    const double* precisions = nullptr; size_t precision_stride = 0; // A_i^{-1}
+    const double* Ax = nullptr;         size_t Ax_stride = 0;        // A_i^{-1} x_i
+    const double* q = nullptr;          size_t q_stride = 0;         // x_i^T A_i^{-1} x_i
+};
+
 // K_epsilon(λ) = ε^2 - C(λ) on the probability simplex
 // Data: centers x_i (d-vectors) and precision matrices A_i^{-1} (d×d, SPD).
+//
+// D is the ambient dimension when known at compile time (see FixedDim.hpp);
+// for D != Eigen::Dynamic every d-sized quantity is a fixed-size Eigen type.
 
-class KObjective {
+template <int D = Eigen::Dynamic>
+class KObjectiveT {
 public:
-    using Vec = Eigen::VectorXd;
+    using Vec = Eigen::VectorXd;   // λ-space (size k) and inputs
     using Mat = Eigen::MatrixXd;
+    using VecD = Eigen::Matrix<double, D, 1>;
+    using MatD = Eigen::Matrix<double, D, D>;
+    using MatDK = Eigen::Matrix<double, D, Eigen::Dynamic>; // d×k, one column per index
+
+    // Everything an evaluation writes, sized for the largest (d, k) seen so far. Shared
+    // by successive objectives (one at a time), building and evaluating a new one does
+    // not allocate once the capacity covers it.
+    struct Workspace {
+        void reserve(int d, int k);       // grow-only in k; a new d resets
+        void reserve_local(int k);        // the per-index copies below
+
+        int d = 0, cap = 0, local_cap = 0;
+        MatD S;                           // S(λ) = sum λ_i A_i^{-1}, SPD
+        Eigen::LLT<MatD> llt;
+        VecD mu, m, Sm, w, diff, t;       // mu(λ), centroid, S m (== mu), hess_vec / distance scratch
+        Vec d2;                           // per-index squared Mahalanobis to m(λ)
+        MatDK R;                          // columns A_j^{-1}(m - x_j)
+        MatDK Y;                          // S^{-1} R (Hessian assembly)
+        // Fields the source lacks, column / block j for the j-th selected index
+        MatDK X, AX;
+        Mat P, L;                         // d × (d·k)
+        Vec q;
+        // solve_pair: G = L_1^{-1} L_2, the eigensystem of G G^T, and the coordinates of
+        // x_2 - x_1 in its basis
+        MatD G;
+        Eigen::SelfAdjointEigenSolver<MatD> eig;
+        VecD gamma, delta;
+    };
+
+    KObjectiveT(double epsilon,
+                const std::vector<Vec>& centers,
+                const std::vector<Mat>& precisions); // A_i^{-1}
+
+    // Same, reusing known lower Cholesky factors L_i of the precisions (A_i^{-1} = L_i L_i^T)
+    KObjectiveT(double epsilon,
+                const std::vector<Vec>& centers,
+                const std::vector<Mat>& precisions,
+                const std::vector<Mat>& factors);
+
+    // Over src restricted to subset (all of src when empty), both held by reference: no
+    // per-index copies. Scratch comes from ws, or from a workspace of its own when null.
+    KObjectiveT(double epsilon, const KSource& src, std::span<const int> subset = {},
+                Workspace* ws = nullptr);
+
+    // Same data as other, read where other reads it (so other must outlive this and stay
+    // bound as it is), with scratch of its own: for evaluating concurrently with other
+    KObjectiveT(const KObjectiveT& other, Workspace* ws);
 
-    KObjective(double epsilon,
-               const std::vector<Vec>& centers,
-               const std::vector<Mat>& precisions); // A_i^{-1}
+    // Same over an EllipsoidSet, whose arena supplies every field
+    KObjectiveT(double epsilon, const EllipsoidSet& set, std::span<const int> subset = {},
+                Workspace* ws = nullptr);
 
-    int k() const noexcept { return static_cast<int>(centers_.size()); }
+    int k() const noexcept { return k_; }
     int d() const noexcept { return dim_; }
 
     // Evaluate K(λ), gradient g, and optionally Hessian H.
@@ -30,27 +100,65 @@ public:
                         Eigen::Ref<Vec> grad,
                         Eigen::Ref<Mat> hess);
 
+    // out = H v at the λ of the last value/value_grad call, without forming H:
+    // H = 2 R^T S^{-1} R with R = [A_j^{-1}(m - x_j)]_j, so O(k·d + d^2) per product
+    // (R itself is built once per λ, O(k·d^2)).
+    void hess_vec(const Eigen::Ref<const Vec>& v, Eigen::Ref<Vec> out);
+
+    // k = 2 only: the minimizer in closed form, with no factorization of S(λ). One
+    // generalized eigendecomposition of (A_1^{-1}, A_2^{-1}) diagonalizes S(λ) for every λ,
+    // which makes m(λ) and both distances O(d) sums; λ* = (1 - t, t) with t the root of
+    // d_1^2 - d_2^2 (increasing in t), found by safeguarded Newton. Writes λ*, leaves
+    // centroid() and mahalanobis_d2() at it (hess_vec needs a value call first) and
+    // returns the root-finder's iterations.
+    int solve_pair(Eigen::Ref<Vec> lambda);
+
     // Accessors for downstream use (distances, m(λ))
-    const Vec& centroid() const noexcept { return m_; }
-    const Vec& mahalanobis_d2() const noexcept { return d2_; } // d_j^2 = (m-x_j)^T A_j^{-1} (m-x_j)
+    const VecD& centroid() const noexcept { return ws_->m; }
+    // d_j^2 = (m-x_j)^T A_j^{-1} (m-x_j)
+    Eigen::VectorBlock<const Vec> mahalanobis_d2() const noexcept { return std::as_const(ws_->d2).head(k_); }
 
 private:
+    // Where field values live: the source (indexed through subset_) or the workspace (local)
+    struct Field {
+        const double* p = nullptr;
+        size_t stride = 0;
+        bool local = false;
+    };
+
     double eps_;
-    int dim_;
-    std::vector<Vec> centers_;
-    std::vector<Mat> Ainv_;      // A_i^{-1}
-    std::vector<double> q_;      // q_i = x_i^T A_i^{-1} x_i
-
-    // Scratch (reused to avoid allocs)
-    Mat S_;            // S(λ) = sum λ_i A_i^{-1}, SPD
-    Eigen::LLT<Mat> lltS_;
-    Vec mu_;           // mu(λ) = sum λ_i A_i^{-1} x_i
-    Vec m_;            // centroid m(λ): solves S m = mu
-    Vec Sm_;           // S*m == mu (cheap to keep)
-    Vec d2_;           // per-index squared Mahalanobis to m(λ)
-
-    void assemble_S_mu(const Vec& lambda); // builds S_, mu_, lltS_
-    void solve_centroid();                  // m_ from S m = mu
+    int dim_ = 0;
+    int k_ = 0;
+    std::span<const int> subset_;  // global index of local j; identity when empty
+    Field X_, Ainv_, L_, Ax_, q_;
+    std::unique_ptr<Workspace> own_;
+    Workspace* ws_ = nullptr;
+    bool R_valid_ = false;         // ws_->R matches ws_->m
+
+    const double* at(const Field& f, int j) const noexcept {
+        const size_t i = (f.local || subset_.empty()) ? static_cast<size_t>(j) : static_cast<size_t>(subset_[j]);
+        return f.p + i * f.stride;
+    }
+    Eigen::Map<const VecD> center(int j) const { return {at(X_, j), dim_}; }
+    Eigen::Map<const MatD> precision(int j) const { return {at(Ainv_, j), dim_, dim_}; }
+    Eigen::Map<const MatD> factor(int j) const { return {at(L_, j), dim_, dim_}; }
+    Eigen::Map<const VecD> precision_center(int j) const { return {at(Ax_, j), dim_}; }
+    double q(int j) const { return *at(q_, j); }
+
+    void assemble_S_mu(const Eigen::Ref<const Vec>& lambda); // builds S, mu, llt
+    void solve_centroid();                  // m from S m = mu
     double C_value() const;                 // sum λ q_i - m^T S m (but S m = mu -> m^T mu)
-    void distances_squared();               // fill d2_[j]
-};
\ No newline at end of file
+    void distances_squared();               // fill d2[j]
+    void build_R();                         // R at the current m
+    void init(const std::vector<Vec>& centers,
+              const std::vector<Mat>& precisions,
+              const std::vector<Mat>* factors); // validate, copy into the workspace
+    void bind(const KSource& src, std::span<const int> subset, Workspace* ws); // validate, derive
+    void use_workspace(Workspace* ws);      // ws_ := ws, or an owned one; sized for k_
+};
+
+using KObjective = KObjectiveT<Eigen::Dynamic>;
+
+#define ELLPH_DECLARE_KOBJECTIVE(D) extern template class KObjectiveT<D>;
+ELLPH_FOR_EACH_DIM(ELLPH_DECLARE_KOBJECTIVE)
+#undef ELLPH_DECLARE_KOBJECTIVE
@@ -1,19 +1,43 @@
 #pragma once
 #include "LPType.hpp"
+#include "EllipsoidSource.hpp"
+
+class WorkStealingPool;
 
 struct ClarksonOptions {
     int rounds = 20;          // outer rounds
     int sample_size = -1;     // if <0, default to 4*(d+1)*(d+1)
     double weight_bad_threshold = 0.5; // if violators carry >50% sampled weight, double
     uint64_t seed = 123;
+
+    // Parallelism. threads > 1 splits each violator scan over a pool and runs the
+    // sample bases concurrently; the result does not depend on threads.
+    int threads = 1;
+    // Caller-owned pool for the above (threads is then ignored), so repeated solves do
+    // not start and join workers each call. Null: a pool of `threads` workers per call.
+    // Must not be called from a task of this pool.
+    WorkStealingPool* pool = nullptr;
+    // Independent weighted samples drawn per round; their bases are computed
+    // concurrently and the first (in draw order) passing the weight test is kept.
+    // 1 reproduces the serial algorithm exactly.
+    int parallel_samples = 1;
 };
 
 struct ClarksonResult {
     LPBasis basis;
-    int violation_tests = 0;
+    long long violation_tests = 0;
     int doublings = 0;
+    PerfCounters perf;  // counters of this call, including its pool workers' share
 };
 
 ClarksonResult clarkson_iterative(const EllipsoidLPOracle& oracle,
                                   const std::vector<int>& S,
-                                  ClarksonOptions opt = {});
\ No newline at end of file
+                                  ClarksonOptions opt = {});
+
+// Out-of-core Clarkson over all of src. Each round's violator scan is one sequential
+// pass over the source; only the weights (one byte per ellipsoid: the doubling count),
+// the sample and the basis are held, plus the source's chunk buffers. The basis is
+// computed by an oracle over the sample alone. basis.idx are indices into src.
+// opt.threads (or opt.pool) splits each chunk's scan over a pool; opt.parallel_samples is ignored.
+ClarksonResult clarkson_streaming(EllipsoidSource& src, const LPParams& params,
+                                  ClarksonOptions opt = {});
@@ -4,14 +4,25 @@
 
 struct SeidelOptions {
     uint64_t seed = 42;
-    int max_depth = -1;     // safety
+    int max_depth = -1;         // cap on frame depth; < 0: unlimited
+    bool move_to_front = false; // Welzl's heuristic: move each new basis to the front of the order
+    bool shuffle = true;        // false: take S in the given order (the caller randomizes)
 };
 
 struct SeidelResult {
     LPBasis basis;
-    int violation_tests = 0;
+    LPEval eval;                // evaluation of basis (m, distances, λ*)
+    long long violation_tests = 0;
+    int depth = 0;              // deepest frame reached
+    PerfCounters perf;          // counters of this call (zero when compiled out)
 };
 
+// Incremental LP-type algorithm (Sharir-Welzl recursion) over a random order of S, run
+// iteratively: each violator opens a frame {next, end, depth} on an explicit stack that
+// re-solves the prefix up to it, so the stack holds one frame per basis improvement and
+// not one per element. Each frame keeps the evaluation of its basis and only re-evaluates
+// when the basis changes; the tests between changes are one scan.
+
 SeidelResult seidel_incremental(const EllipsoidLPOracle& oracle,
                                 const std::vector<int>& S,
                                 SeidelOptions opt = {});
\ No newline at end of file
@@ -1,11 +1,19 @@
 // LPType.hpp
 #pragma once
 #include "Ellipsoid.hpp"
+#include "EllipsoidDataset.hpp"
+#include "EllipsoidSet.hpp"
 #include "KFromEllipsoids.hpp"
 #include "OptimalRadius.hpp"
+#include "OracleCache.hpp"
+#include "PerfCounters.hpp"
+#include "SpatialIndex.hpp"
+#include <memory>
 #include <vector>
 #include <optional>
 #include <random>
+#include <span>
+#include <atomic>
 
 struct LPBasis {
     std::vector<int> idx;      // indices into the global array S = {0..n-1}
@@ -16,51 +24,142 @@ struct LPEval {
     double eps_star;           // f(B)
     Eigen::VectorXd m;         // centroid at λ*
     Eigen::VectorXd dists;     // per-ellipse distances at m
-    Eigen::VectorXd lambda;    // λ* on B (size |B|)
-};
-
-struct CacheVal {
-    double eps_star;
-    Eigen::VectorXd m;
+    Eigen::VectorXd lambda;    // λ* on B (size |B|, caller's order)
 };
 
 struct LPParams {
-    SolverKind inner = SolverKind::SLSQP; // your 3 options
+    SolverKind inner = SolverKind::SLSQP; // PGD, Cauchy, SLSQP or Newton
     double tight_tol = 1e-5;              // d_j within tol of eps* => tight
+    bool fixed_dim = true;                // stack-allocated objective when d <= kMaxFixedDim
+    size_t cache_capacity = size_t(1) << 16; // memoized f(B) entries (LRU); 0 disables
+    bool warm_start = true;               // seed inner solves with λ* of a known sub-basis
+    // Violation scans read a float copy of the factors (packed lower triangles) and redo
+    // in double only the elements whose float distance is within its error bound of the
+    // threshold, so every decision matches the double-only scan
+    bool float_scan = false;
+    // Build a SpatialIndex over the centers (and per-ellipsoid eigenvalue bounds), used by
+    // violators_all; worthwhile for large n in low d
+    bool spatial_index = false;
 };
 
 class EllipsoidLPOracle {
     public:
-        EllipsoidLPOracle(const std::vector<Ellipsoid>& all, int ambient_dim, LPParams p);
+        // Centers and precision factors are copied into packed arrays; all need not outlive it
+        EllipsoidLPOracle(std::span<const Ellipsoid> all, int ambient_dim, LPParams p);
+
+        // Over a mapped dataset (held by reference). Centers, and blocks stored as full
+        // Cholesky factors, are read in place; other block layouts are unpacked once.
+        EllipsoidLPOracle(const EllipsoidDataset& ds, LPParams p);
+
+        // Over an EllipsoidSet (held by reference): every kernel and objective reads its arena
+        EllipsoidLPOracle(const EllipsoidSet& set, LPParams p);
 
         
 
-        // Evaluate f(B) and related quantities (over B only)
-        LPEval evaluate(const std::vector<int>& B) const;
+        // Evaluate f(B) and related quantities (over B only).
+        // On a cache miss, (warm, evWarm) -- a set solved before, typically the basis B is
+        // grown from -- seeds the inner solver with evWarm.lambda, zero on the new indices.
+        LPEval evaluate(const std::vector<int>& B,
+                        const LPBasis* warm = nullptr, const LPEval* evWarm = nullptr) const;
 
         // Violation test: does i violate the basis B?
         bool is_violator(const LPBasis& B, int i) const;
 
         bool is_violator(const LPBasis& B, int i, const LPEval& evB) const;
 
-        // Compute (a) tight set for C, (b) reduced basis <= d+1 indices
-        LPBasis compute_basis(const std::vector<int>& C) const;
+        // Batched violation test against a fixed evaluation of B.
+        // Returns the positions t (into `candidates`) with d_{candidates[t]}(m) > eps* + tol,
+        // compared on squared distances so no sqrt is taken per element.
+        std::vector<int> violators(const LPBasis& B, const LPEval& evB,
+                                   std::span<const int> candidates) const;
+
+        // Position of the first violator of B among candidates, or -1; stops at the hit
+        int first_violator(const LPBasis& B, const LPEval& evB,
+                           std::span<const int> candidates) const;
+
+        // Violators of B among all n elements, as increasing indices: the same list as
+        // violators() over 0..n-1. With LPParams::spatial_index a SpatialIndex query that
+        // runs the exact test only where the eigenvalue bounds are ambiguous, so its cost
+        // follows the shell around eps* rather than n.
+        std::vector<int> violators_all(const LPBasis& B, const LPEval& evB) const;
+        bool has_spatial_index() const noexcept { return index_ != nullptr; }
+
+        // Compute (a) tight set for C, (b) reduced basis <= d+1 indices that no element of
+        // C lies outside of by more than max(tight_tol, 1e-6·eps*) (a lost element is added
+        // back). (warm, evWarm) is forwarded to evaluate(C) as its warm start.
+        // Throws std::runtime_error when no such basis is found (see also evaluate()).
+        LPBasis compute_basis(const std::vector<int>& C,
+                              const LPBasis* warm = nullptr, const LPEval* evWarm = nullptr) const;
 
         int d() const noexcept { return d_; }
-        int n() const noexcept { return static_cast<int>(all_.size()); }
+        int n() const noexcept { return n_; }
+
+        // Memo cache counters (hits / misses / evictions / current size)
+        OracleCacheStats cache_stats() const { return cache_.stats(); }
+
+        // Inner solves run on cache misses, and the solver iterations they took
+        long long inner_solves() const noexcept { return inner_solves_.load(std::memory_order_relaxed); }
+        long long inner_iterations() const noexcept { return inner_iters_.load(std::memory_order_relaxed); }
+        // Of the inner solves, those LPParams::inner did not certify (unconverged, or gap
+        // above kWarmGapTol) and a second solver redid; evaluate() throws std::runtime_error
+        // when that one fails too
+        long long fallback_solves() const noexcept { return fallback_solves_.load(std::memory_order_relaxed); }
 
     private:
-        const std::vector<Ellipsoid>& all_;
+        const Ellipsoid* all_ = nullptr; // one of all_ / ds_ / set_
+        const EllipsoidDataset* ds_ = nullptr;
+        const EllipsoidSet* set_ = nullptr;
+        int n_;
         int d_;
         LPParams P_;
+
+        // Data streamed by the violation kernel: center i at cptr_ + i·cstride_, and
+        // L_i (d×d column-major, A_i^{-1} = L_i L_i^T) at fptr_ + i·fstride_. They point
+        // into the packed copies below, or straight into a mapped dataset.
+        const double* cptr_ = nullptr;
+        const double* fptr_ = nullptr;
+        size_t cstride_ = 0, fstride_ = 0;
+        Eigen::MatrixXd centers_;   // d × n, column i = c_i
+        Eigen::MatrixXd factors_;   // d × (d·n), block i = L_i
+        KSource src_;               // the same arrays, as read by make_K_for_subset
+        void bind_source();         // src_ from the pointers above (and set_); float copies
+
+        // LPParams::float_scan: center i at fcenters_[i·d], packed lower L_i at
+        // ffactors_[i·d(d+1)/2] (column k holds rows k..d-1), and the norms the error
+        // bound needs
+        std::vector<float> fcenters_, ffactors_;
+        std::vector<double> lnorm_, cnorm_; // ||L_i||_F, ||c_i||
+
+        std::unique_ptr<SpatialIndex> index_; // LPParams::spatial_index
+
+        // d_i(m)^2 > r2, decided in float when the error bound allows, else in double
+        // (counted in fallbacks). mf = m in float, mnorm = ||m||; diff / fdiff are scratch.
+        bool exceeds_mixed(int i, const Eigen::VectorXd& m, const Eigen::VectorXf& mf, double mnorm,
+                           double r2, Eigen::VectorXd& diff, Eigen::VectorXf& fdiff,
+                           long long& fallbacks) const;
+
+        Eigen::Map<const Eigen::VectorXd> center_of(int i) const {
+            return {cptr_ + static_cast<size_t>(i) * cstride_, d_};
+        }
+        Eigen::Map<const Eigen::MatrixXd> factor_of(int i) const {
+            return {fptr_ + static_cast<size_t>(i) * fstride_, d_, d_};
+        }
+
+        // ||L_i^T (m - c_i)||^2 on the packed arrays; diff is caller scratch
+        double mahalanobis2_packed(int i, const Eigen::VectorXd& m, Eigen::VectorXd& diff) const;
         // mutable std::unordered_map<uint64_t, LPEval> cache_;
         // static uint64_t key_from_indices(const std::vector<int>& idx);
 
-        mutable std::unordered_map<uint64_t, CacheVal> cache_;
-        static uint64_t key_from_set(const std::vector<int>& idx); // sorts internally
+        // f(B) memo, keyed by the exact sorted index set; safe to share across threads
+        mutable OracleCache cache_;
+        mutable std::atomic<long long> inner_solves_{0};
+        mutable std::atomic<long long> inner_iters_{0};
+        mutable std::atomic<long long> fallback_solves_{0};
 
-        // helper to build KObjective from a subset
-        KObjective make_K_for_subset(const std::vector<int>& subset) const;
+        // KObjective over a subset of src_, held by reference (D = Eigen::Dynamic or d_).
+        // Uses a per-thread workspace: at most one such objective alive per thread and D.
+        template <int D>
+        KObjectiveT<D> make_K_for_subset(std::span<const int> subset) const;
 
         // shrink a tight set deterministically to <= d_+1 indices
         std::vector<int> shrink_tight(const std::vector<int>& tight,
@@ -0,0 +1,27 @@
+#pragma once
+#include "KObjective.hpp"
+#include <atomic>
+
+struct NewtonOptions {
+    int max_iters = 100;
+    double tol = 1e-10;
+    double active_tol = 1e-14; // λ_i below this counts as on the boundary
+    double reg = 1e-12;        // relative Tikhonov shift for singular reduced Hessians
+    double armijo_beta = 0.5;
+    double armijo_c = 1e-4;
+    const std::atomic<bool>* cancel = nullptr; // polled once per iteration; stops unconverged when set
+};
+
+struct NewtonResult {
+    Eigen::VectorXd lambda;
+    double fval;
+    int iters;
+    bool converged;
+    int newton_steps = 0; // iterations that took a (damped) Newton step
+};
+
+// Active-set projected Newton on the simplex: Newton steps on the free face with
+// sum(λ) = 1 eliminated, projected-gradient steps when the reduced Hessian is indefinite.
+// Obj is any KObjectiveT<D> (instantiated for ELLPH_FOR_EACH_DIM)
+template <class Obj>
+NewtonResult minimize_newton(Obj& obj, const Eigen::VectorXd& lambda0, const NewtonOptions& opt);
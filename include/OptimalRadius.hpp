@@ -1,16 +1,112 @@
 #pragma once
 #include "KObjective.hpp"
+#include "Ellipsoid.hpp"
 #include "PGD.hpp"
 #include "SLSQP.hpp"
 #include "CauchySimplex.hpp"
+#include "Newton.hpp"
+#include "PerfCounters.hpp"
+#include <algorithm>
+#include <array>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
 
 
+class WorkStealingPool;
+
 struct EpsStar {
     double eps_star;
     Eigen::VectorXd lambda_star;
     Eigen::VectorXd dists; // per-ellipse distances at m(λ*)
+    int iters = 0;         // inner solver iterations (SLSQP: objective evaluations)
+    bool converged = false; // met the solver's tolerance before its iteration cap
+    double gap = 0.0;      // Frank-Wolfe gap max_i d_i^2 - sum_i λ_i d_i^2 at λ* (>= K(λ*) - min K)
+};
+
+// A warm-started solve whose gap exceeds this times max(1, max_i d_i^2) is redone from
+// the uniform start
+inline constexpr double kWarmGapTol = 1e-6;
+
+// The certificate on an EpsStar: gap <= tol · max(1, max_i d_i^2)
+inline bool gap_within(const EpsStar& e, double tol = kWarmGapTol) {
+    return e.gap <= tol * std::max(1.0, e.eps_star * e.eps_star);
+}
+
+// Portfolio races the others (optimal_radius_portfolio with default options); it is not
+// a counter index, each racer is counted under its own kind
+enum class SolverKind { PGD, Cauchy, SLSQP, Newton, Portfolio };
+
+// Portfolio wins per (k, d) bucket, for picking a default solver per bucket. k is bucketed
+// to powers of two (k_bucket), d is exact. Thread-safe.
+class PortfolioStats {
+public:
+    struct Bucket {
+        long long races = 0;
+        long long uncertified = 0; // races no racer passed the certificate in
+        std::array<long long, kNumSolverKinds> wins{}; // indexed by SolverKind
+    };
+
+    static int k_bucket(int k) noexcept; // largest power of two <= k
+
+    void record(int k, int d, std::optional<SolverKind> winner);
+    Bucket bucket(int k, int d) const;
+    // The kind with the most wins in the bucket of (k, d), or fallback when none is recorded
+    SolverKind best(int k, int d, SolverKind fallback = SolverKind::Newton) const;
+    std::map<std::pair<int, int>, Bucket> snapshot() const; // (k_bucket, d) -> bucket
+    void reset();
+
+private:
+    mutable std::mutex mu_;
+    std::map<std::pair<int, int>, Bucket> buckets_;
+};
+
+// The process-wide statistics the portfolio records into by default
+PortfolioStats& portfolio_stats();
+
+struct PortfolioOptions {
+    std::vector<SolverKind> solvers{SolverKind::PGD, SolverKind::Cauchy, SolverKind::SLSQP, SolverKind::Newton};
+    // Optimality certificate: the Frank-Wolfe gap max_i d_i^2 - sum_i λ_i d_i^2 (an upper
+    // bound on K(λ) - K(λ*)) at most cert_tol · max(1, max_i d_i^2)
+    double cert_tol = 1e-8;
+    PortfolioStats* stats = nullptr; // null: portfolio_stats(); records every real race
+    bool record = true;
+    // Pool the racers run on. Null: a process-wide pool of hardware_concurrency()
+    // workers, created on first use and kept.
+    WorkStealingPool* pool = nullptr;
 };
 
-enum class SolverKind { PGD, Cauchy, SLSQP };
+struct PortfolioResult {
+    EpsStar est;                      // at the winner's λ*
+    std::optional<SolverKind> winner; // empty when k = 2 (closed form) or none was certified
+    double gap = 0.0;                 // certificate value of the returned λ*
+};
+
+// lambda0: optional warm start on the simplex (size k); uniform when null. Cauchy always
+// starts uniform (its multiplicative steps stall near the zeros of a warm start), and a
+// warm solve failing kWarmGapTol is repeated cold.
+template <int D>
+EpsStar optimal_radius(KObjectiveT<D>& obj, SolverKind solver,
+                       const Eigen::VectorXd* lambda0 = nullptr);
+
+// Runs the solvers of opt concurrently on opt.pool, each on its own KObjectiveT sharing
+// obj's data, with a shared cancellation token. The first result to pass the certificate
+// wins and cancels the rest; when none passes, the smallest gap is returned. Called from
+// a pool worker, the solvers run in turn on that thread up to the first certified one;
+// such a run is not a race and is not recorded in opt.stats. obj is left at the returned
+// λ* as after optimal_radius.
+template <int D>
+PortfolioResult optimal_radius_portfolio(KObjectiveT<D>& obj, const PortfolioOptions& opt,
+                                         const Eigen::VectorXd* lambda0 = nullptr);
+
+// Builds the objective itself, on the fixed-size path when d <= kMaxFixedDim
+EpsStar optimal_radius(const std::vector<Ellipsoid>& Es, SolverKind solver, double epsilon = 1.0);
 
-EpsStar optimal_radius(KObjective& obj, SolverKind solver);
\ No newline at end of file
+#define ELLPH_DECLARE_OPTIMAL_RADIUS(D) \
+    extern template EpsStar optimal_radius(KObjectiveT<D>&, SolverKind, const Eigen::VectorXd*); \
+    extern template PortfolioResult optimal_radius_portfolio(KObjectiveT<D>&, const PortfolioOptions&, \
+                                                             const Eigen::VectorXd*);
+ELLPH_FOR_EACH_DIM(ELLPH_DECLARE_OPTIMAL_RADIUS)
+#undef ELLPH_DECLARE_OPTIMAL_RADIUS
@@ -0,0 +1,94 @@
+#pragma once
+#include <Eigen/Dense>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+// Memoized f(B) for the LP-type oracle
+struct CacheVal {
+    double eps_star;
+    Eigen::VectorXd m;
+    Eigen::VectorXd lambda; // λ*, aligned with the key's sorted indices
+};
+
+// Order-insensitive key for an index set: the sorted indices themselves (so lookups
+// compare the exact set, never just a hash) with inline storage for small sets.
+class IndexKey {
+public:
+    static constexpr int kInline = 8; // bases have <= d+2 elements; covers d <= 6 heap-free
+
+    IndexKey() = default;
+    explicit IndexKey(std::span<const int> idx); // copies and sorts
+
+    std::span<const int> indices() const noexcept {
+        return {size_ <= kInline ? small_.data() : large_.data(), static_cast<size_t>(size_)};
+    }
+    int size() const noexcept { return size_; }
+    uint64_t hash() const noexcept { return hash_; }
+
+    bool operator==(const IndexKey& o) const noexcept;
+
+private:
+    int size_ = 0;
+    uint64_t hash_ = 0;
+    std::array<int, kInline> small_{};
+    std::vector<int> large_; // only when size_ > kInline
+};
+
+struct OracleCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t size = 0;
+};
+
+// Thread-safe bounded memo cache: the key space is split over independently locked
+// shards, each holding an LRU list capped at capacity / shards entries.
+class OracleCache {
+public:
+    struct Options {
+        size_t capacity = size_t(1) << 16; // total entries; 0 disables caching
+        int shards = 16;
+    };
+
+    explicit OracleCache(Options opt);
+
+    // Copies the cached value into out and marks it most recently used
+    bool find(const IndexKey& key, CacheVal& out);
+
+    // Insert (or refresh) key; evicts the least recently used entry of a full shard
+    void insert(const IndexKey& key, const CacheVal& val);
+
+    OracleCacheStats stats() const;
+    void clear();
+
+private:
+    struct KeyHash {
+        size_t operator()(const IndexKey& k) const noexcept { return static_cast<size_t>(k.hash()); }
+    };
+    using Entry = std::pair<IndexKey, CacheVal>;
+    using LRU = std::list<Entry>;
+
+    struct alignas(64) Shard {
+        std::mutex mu;
+        LRU lru; // front = most recently used
+        std::unordered_map<IndexKey, LRU::iterator, KeyHash> map;
+    };
+
+    size_t shard_cap_;
+    std::unique_ptr<Shard[]> shards_;
+    int nshards_;
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+
+    Shard& shard_for(const IndexKey& key);
+};
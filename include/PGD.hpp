@@ -1,5 +1,6 @@
 #pragma once
 #include "KObjective.hpp"
+#include <atomic>
 
 struct PGDOptions {
     int max_iters = 500;
@@ -8,6 +9,7 @@ struct PGDOptions {
     double armijo_beta = 0.5;
     double armijo_c = 1e-4;
     bool use_hessian_safeguard = false; // optional
+    const std::atomic<bool>* cancel = nullptr; // polled once per iteration; stops unconverged when set
 };
 
 struct PGDResult {
@@ -17,4 +19,6 @@ struct PGDResult {
     bool converged;
 };
 
-PGDResult minimize_pgd(KObjective& obj, const Eigen::VectorXd& lambda0, const PGDOptions& opt);
\ No newline at end of file
+// Obj is any KObjectiveT<D> (instantiated for ELLPH_FOR_EACH_DIM)
+template <class Obj>
+PGDResult minimize_pgd(Obj& obj, const Eigen::VectorXd& lambda0, const PGDOptions& opt);
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+#include <array>
+#include <chrono>
+
+// Per-thread performance counters, updated by the objective, the solvers and the LP-type
+// oracle. Building with ELLPH_PERF_COUNTERS=0 (CMake option ELLPH_PERF_COUNTERS=OFF)
+// compiles every update out; the structs remain and stay zero.
+#ifndef ELLPH_PERF_COUNTERS
+#define ELLPH_PERF_COUNTERS 1
+#endif
+
+inline constexpr int kNumSolverKinds = 4; // SolverKind::{PGD, Cauchy, SLSQP, Newton}
+
+// Timed phases. Solve is the inner solves run on cache misses and nests inside Basis
+// (compute_basis); Scan is the batched violation tests.
+enum class PerfPhase { Solve, Basis, Scan };
+inline constexpr int kNumPerfPhases = 3;
+
+struct SolverPerf {
+    long long solves = 0;
+    long long iterations = 0; // SLSQP: objective evaluations
+    long long converged = 0;  // solves that met their tolerance before the iteration cap
+};
+
+struct PerfCounters {
+    long long objective_evals = 0;    // K(λ) evaluations (value, value_grad, value_grad_hess)
+    long long llt_factorizations = 0; // S(λ) and Newton reduced-Hessian factorizations
+    long long llt_failures = 0;       // of those, not SPD
+    std::array<SolverPerf, kNumSolverKinds> solver{}; // indexed by SolverKind
+    long long pair_solves = 0;        // of those, k = 2 solved in closed form
+    long long warm_retries = 0;       // warm-started solves redone cold (gap above kWarmGapTol)
+    long long cache_hits = 0;         // oracle memo cache
+    long long cache_misses = 0;
+    long long basis_calls = 0;        // compute_basis
+    long long basis_repairs = 0;      // of its reductions, rounds re-adding a lost basis element
+    long long float_tests = 0;        // violation tests decided in float (LPParams::float_scan)
+    long long float_fallbacks = 0;    // of those, redone in double near the threshold
+    std::array<double, kNumPerfPhases> phase_ms{}; // thread time, summed over threads
+
+    double ms(PerfPhase p) const noexcept { return phase_ms[static_cast<int>(p)]; }
+    SolverPerf solver_total() const noexcept;
+
+    PerfCounters& operator+=(const PerfCounters& o) noexcept;
+    PerfCounters& operator-=(const PerfCounters& o) noexcept;
+};
+
+inline PerfCounters operator+(PerfCounters a, const PerfCounters& b) noexcept { return a += b; }
+inline PerfCounters operator-(PerfCounters a, const PerfCounters& b) noexcept { return a -= b; }
+
+namespace perf {
+
+inline thread_local PerfCounters tls_counters;
+
+// The calling thread's counters (monotone; take differences with Scope)
+inline PerfCounters& local() noexcept { return tls_counters; }
+
+// Counters accumulated by this thread since construction. Work a call hands to pool
+// workers is measured there with its own Scope and folded back with absorb().
+class Scope {
+public:
+    Scope() noexcept : start_(local()) {}
+    PerfCounters delta() const noexcept { return local() - start_; }
+
+private:
+    PerfCounters start_;
+};
+
+inline void absorb(const PerfCounters& c) noexcept {
+#if ELLPH_PERF_COUNTERS
+    local() += c;
+#else
+    (void)c;
+#endif
+}
+
+// Adds the wall time of its lifetime to a phase of this thread's counters
+class PhaseTimer {
+public:
+    explicit PhaseTimer(PerfPhase p) noexcept : p_(p), t0_(std::chrono::steady_clock::now()) {}
+    ~PhaseTimer() {
+        const std::chrono::duration<double, std::milli> dt = std::chrono::steady_clock::now() - t0_;
+        local().phase_ms[static_cast<int>(p_)] += dt.count();
+    }
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    PerfPhase p_;
+    std::chrono::steady_clock::time_point t0_;
+};
+
+} // namespace perf
+
+#if ELLPH_PERF_COUNTERS
+#define ELLPH_PERF_ADD(field, v) (perf::local().field += (v))
+#define ELLPH_PERF_PHASE(name, phase) perf::PhaseTimer name(phase)
+#else
+#define ELLPH_PERF_ADD(field, v) ((void)0)
+#define ELLPH_PERF_PHASE(name, phase) ((void)0)
+#endif
@@ -0,0 +1,100 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+// Counter-based generator: Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy
+// as 1, 2, 3", SC'11). Output block t of stream s under key k is a pure function of
+// (k, s, t), so independent streams -- e.g. one per ellipsoid index -- can be drawn on
+// any thread in any order and reproduce the same values. A UniformRandomBitGenerator;
+// uniform() and normal() are defined here exactly, unlike the std distributions.
+class Philox4x32 {
+public:
+    using result_type = std::uint64_t;
+
+    Philox4x32(std::uint64_t seed, std::uint64_t stream) noexcept
+    : key_{lo(seed), hi(seed)}, ctr_{0u, 0u, lo(stream), hi(stream)} {}
+
+    static constexpr result_type min() noexcept { return 0; }
+    static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() noexcept {
+        if (pos_ == kBuf) refill();
+        return buf_[pos_++];
+    }
+
+    // Uniform on [0, 1), 53 random bits
+    double uniform() noexcept { return static_cast<double>((*this)() >> 11) * 0x1.0p-53; }
+    double uniform(double a, double b) noexcept { return a + (b - a) * uniform(); }
+
+    // Standard normal by Marsaglia's polar method (one log, no trig per pair); the second
+    // value of each pair is kept for the next call
+    double normal() noexcept {
+        if (has_spare_) { has_spare_ = false; return spare_; }
+        double u, v, s;
+        do {
+            u = 2.0 * uniform() - 1.0;
+            v = 2.0 * uniform() - 1.0;
+            s = u * u + v * v;
+        } while (s >= 1.0 || s == 0.0);
+        const double f = std::sqrt(-2.0 * std::log(s) / s);
+        spare_ = v * f;
+        has_spare_ = true;
+        return u * f;
+    }
+
+    // The raw block function: 10 rounds over ctr under key
+    static std::array<std::uint32_t, 4> block(std::array<std::uint32_t, 4> ctr,
+                                              std::array<std::uint32_t, 2> key) noexcept {
+        for (int r = 0; r < 10; ++r) {
+            if (r > 0) { key[0] += kW0; key[1] += kW1; }
+            const std::uint64_t p0 = std::uint64_t(kM0) * ctr[0];
+            const std::uint64_t p1 = std::uint64_t(kM1) * ctr[2];
+            ctr = {hi(p1) ^ ctr[1] ^ key[0], lo(p1), hi(p0) ^ ctr[3] ^ key[1], lo(p0)};
+        }
+        return ctr;
+    }
+
+private:
+    static constexpr std::uint32_t kM0 = 0xD2511F53u, kM1 = 0xCD9E8D57u; // multipliers
+    static constexpr std::uint32_t kW0 = 0x9E3779B9u, kW1 = 0xBB67AE85u; // key schedule
+
+    static constexpr std::uint32_t lo(std::uint64_t x) noexcept { return static_cast<std::uint32_t>(x); }
+    static constexpr std::uint32_t hi(std::uint64_t x) noexcept { return static_cast<std::uint32_t>(x >> 32); }
+
+    std::array<std::uint32_t, 2> key_;
+    std::array<std::uint32_t, 4> ctr_; // words 0-1: block counter, 2-3: stream
+    // Four consecutive blocks per refill, computed side by side so their rounds overlap
+    static constexpr int kLanes = 4, kBuf = 2 * kLanes;
+    std::array<std::uint64_t, kBuf> buf_{};
+    int pos_ = kBuf;
+    bool has_spare_ = false;
+    double spare_ = 0.0;
+
+    void refill() noexcept {
+        // Word w of lane l in x[w][l] (structure of arrays, so the lanes vectorize)
+        std::uint32_t x[4][kLanes];
+        for (int l = 0; l < kLanes; ++l) {
+            for (int w = 0; w < 4; ++w) x[w][l] = ctr_[w];
+            if (++ctr_[0] == 0) ++ctr_[1];
+        }
+        std::uint32_t k0 = key_[0], k1 = key_[1];
+        for (int r = 0; r < 10; ++r) {
+            if (r > 0) { k0 += kW0; k1 += kW1; }
+            for (int l = 0; l < kLanes; ++l) {
+                const std::uint64_t p0 = std::uint64_t(kM0) * x[0][l];
+                const std::uint64_t p1 = std::uint64_t(kM1) * x[2][l];
+                x[0][l] = hi(p1) ^ x[1][l] ^ k0;
+                x[1][l] = lo(p1);
+                x[2][l] = hi(p0) ^ x[3][l] ^ k1;
+                x[3][l] = lo(p0);
+            }
+        }
+        for (int l = 0; l < kLanes; ++l) {
+            buf_[2 * l] = x[0][l] | std::uint64_t(x[1][l]) << 32;
+            buf_[2 * l + 1] = x[2][l] | std::uint64_t(x[3][l]) << 32;
+        }
+        pos_ = 0;
+    }
+};
@@ -1,8 +1,12 @@
 #pragma once
 #include "Ellipsoid.hpp"
-#include <random>
+#include "EllipsoidSet.hpp"
+#include "Philox.hpp"
+#include <cstdint>
 #include <vector>
 
+// Ellipsoid i is drawn from its own counter-based stream Philox4x32(seed, i), so the
+// output depends only on the options -- not on threads or on the order of generation.
 class RandomEllipsoidGenerator {
 public:
     enum class CenterMode { UniformHypercube, Gaussian };
@@ -33,6 +37,9 @@ public:
 
         // RNG seed
         uint64_t seed = 42ULL;
+
+        // Workers drawing ellipsoids in parallel; <= 0: hardware concurrency
+        int threads = 1;
     };
 
     explicit RandomEllipsoidGenerator(Options opts);
@@ -40,21 +47,34 @@ public:
     // Main API
     std::vector<Ellipsoid> generate();
 
+    // Same instances written straight into an arena; always stores the precision
+    // (store_covariance does not apply)
+    EllipsoidSet generate_set();
+
 private:
     using Vec = Eigen::VectorXd;
     using Mat = Eigen::MatrixXd;
 
     Options opts_;
-    std::mt19937_64 rng_;
+
+    // One ellipsoid's draw: its center and whichever of Σ / A^{-1} was asked for
+    struct Draw {
+        Vec center;
+        Mat cov;
+        Mat prec;
+    };
+    Draw draw(int i, bool want_cov, bool want_prec) const;
 
     // Centers
-    Vec sample_center();
+    Vec sample_center(Philox4x32& rng) const;
     // Orthonormal Q via QR of Gaussian matrix
-    Mat random_orthonormal(int d);
-    // SPD construction
-    Mat spd_from_loguniform_spectrum();
-    Mat spd_from_wishart();
+    Mat random_orthonormal(Philox4x32& rng, int d) const;
+    // Σ and / or A^{-1} = Σ^{-1}: from the sampled spectrum (Q diag(λ^{±1}) Q^T), or from
+    // a Wishart draw and its Cholesky factor
+    void spd_from_loguniform_spectrum(Philox4x32& rng, Draw& out, bool want_cov, bool want_prec) const;
+    void spd_from_wishart(Philox4x32& rng, Draw& out, bool want_cov, bool want_prec) const;
 
     // Helpers
-    static Mat make_cov_from_spectrum(const Mat& Q, const Vec& evals);
+    static Mat make_cov_from_spectrum(const Mat& Q, const Vec& evals); // Q diag(evals) Q^T
+    template <class F> void for_each_index(F&& f) const;                // f(i), i in [0, n)
 };
\ No newline at end of file
@@ -1,17 +1,22 @@
 #pragma once
 #include "KObjective.hpp"
+#include <atomic>
 #include <nlopt.hpp>
 
 struct NloptOptions {
     int max_evals = 2000;
     double rel_tol = 1e-8;
     double abs_tol = 1e-10;
+    const std::atomic<bool>* cancel = nullptr; // polled per evaluation; force_stop when set
 };
 
 struct NloptResult {
     Eigen::VectorXd lambda;
     double fval;
     nlopt::result status;
+    int evals = 0;          // objective evaluations used
 };
 
-NloptResult minimize_slsqp(KObjective& obj, const Eigen::VectorXd& lambda0, const NloptOptions& opt);
\ No newline at end of file
+// Obj is any KObjectiveT<D> (instantiated for ELLPH_FOR_EACH_DIM)
+template <class Obj>
+NloptResult minimize_slsqp(Obj& obj, const Eigen::VectorXd& lambda0, const NloptOptions& opt);
\ No newline at end of file
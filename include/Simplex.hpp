@@ -1,15 +1,28 @@
 #pragma once
 #include <Eigen/Dense>
+#include <cstdint>
+#include <vector>
 
 namespace Simplex {
 
+// Scratch for the in-place projection; grows to the largest k seen, then reused
+struct Workspace {
+    std::vector<double> buf;
+    std::uint64_t rng = 0x9E3779B97F4A7C15ull; // pivot selection (xorshift)
+
+    void reserve(int k) { if ((int)buf.size() < k) buf.resize(k); }
+};
+
 // Project z onto the probability simplex Δ_k = {λ ≥ 0, 1^T λ = 1}.
 Eigen::VectorXd project_to_simplex(const Eigen::VectorXd& z);
 
+// Same, in place, expected O(k) (randomized pivot) and allocation-free once ws has grown to k
+void project_to_simplex(Eigen::Ref<Eigen::VectorXd> z, Workspace& ws);
+
 // Make a strictly interior start (optional).
 Eigen::VectorXd uniform_start(int k) ;
 
 // Backtracking Armijo on the simplex along a feasible direction dir with projection.
 struct ArmijoParams { double alpha0=1.0, beta=0.5, c=1e-4, min_alpha=1e-12; };
 
-}
\ No newline at end of file
+}
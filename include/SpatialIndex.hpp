@@ -0,0 +1,54 @@
+#pragma once
+#include <Eigen/Dense>
+#include <cstddef>
+#include <vector>
+
+// k-d tree over ellipsoid centers for violator queries against a centroid m.
+//
+// With λ_min(A_i^{-1}) ||m - c_i||^2 <= d_i(m)^2 <= λ_max(A_i^{-1}) ||m - c_i||^2, a node
+// whose box of centers is far enough from m (times the smallest λ_min below it) holds
+// only violators, and one close enough (times the largest λ_max) holds none. A query
+// settles such nodes whole and leaves only the elements whose bounds straddle the
+// threshold -- the shell around eps* -- to the exact test. Elements are stored in leaf
+// order, so a leaf's centers and bounds are contiguous.
+class SpatialIndex {
+public:
+    struct Stats {
+        long long nodes_visited = 0;
+        long long settled = 0;   // elements decided by the bounds alone
+        long long ambiguous = 0; // elements left to the exact test
+    };
+
+    // centers: c_i at centers + i·stride (d doubles); lmin / lmax: eigenvalue bounds of
+    // each precision A_i^{-1} (lower / upper), n each
+    SpatialIndex(const double* centers, size_t stride, int n, int d,
+                 std::vector<double> lmin, std::vector<double> lmax);
+
+    // Elements with d_i(m)^2 > r2 by the bounds alone go to sure, those the bounds cannot
+    // settle to ambiguous (both unordered, appended); the rest pass. Bounds carry a
+    // relative slack covering rounding in the eigenvalues and in the exact test, so an
+    // element is settled only when the exact test would agree.
+    void query(const Eigen::VectorXd& m, double r2, std::vector<int>& sure,
+               std::vector<int>& ambiguous, Stats* stats = nullptr) const;
+
+    int n() const noexcept { return n_; }
+    int d() const noexcept { return d_; }
+
+private:
+    static constexpr int kLeafSize = 32;
+
+    struct Node {
+        int begin, end;      // element range in leaf order
+        int left = -1, right = -1; // children, -1 at a leaf
+        double lmin = 0.0, lmax = 0.0; // extreme eigenvalue bounds below the node
+    };
+
+    int n_, d_;
+    std::vector<Node> nodes_;
+    std::vector<double> box_;  // node j: lower corner at box_[2·d·j], upper corner after it
+    std::vector<int> id_;      // element index at each leaf-order position
+    Eigen::MatrixXd centers_;  // d × n, leaf order
+    std::vector<double> lmin_, lmax_; // leaf order
+
+    int build(int begin, int end);
+};
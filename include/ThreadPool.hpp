@@ -0,0 +1,97 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool.
+// Each worker owns a deque: it pops its own tasks LIFO and, when empty, steals FIFO
+// from the other workers. Tasks must not block on the pool they run on.
+class WorkStealingPool {
+public:
+    struct Options {
+        int threads = 0;          // <= 0 => std::thread::hardware_concurrency()
+        bool pin_threads = false; // pin worker w to core w % #cores (Linux only; ignored elsewhere)
+    };
+
+    explicit WorkStealingPool(Options opt);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int size() const noexcept { return static_cast<int>(workers_.size()); }
+
+    // Enqueue a task (round-robin over the worker deques)
+    void submit(std::function<void()> task);
+
+    // Block until every task on the pool has finished, whoever submitted it; rethrows the
+    // first exception of a task passed to submit() (parallel_for keeps its own)
+    void wait_idle();
+
+    // Run f(i) for i in [begin, end), grain consecutive indices per task, and wait for
+    // those tasks only; rethrows the first exception one of them threw. Several threads
+    // may call it on one pool at once. Inside f, current_worker() identifies the worker
+    // for per-worker accumulators.
+    template <class F>
+    void parallel_for(int begin, int end, F&& f, int grain = 1) {
+        grain = std::max(1, grain);
+        if (end <= begin) return;
+        Group group((end - begin + grain - 1) / grain);
+        for (int lo = begin; lo < end; lo += grain) {
+            const int hi = std::min(end, lo + grain);
+            submit([&f, &group, lo, hi]() {
+                std::exception_ptr error;
+                try {
+                    for (int i = lo; i < hi; ++i) f(i);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                group.finish(error);
+            });
+        }
+        group.wait();
+    }
+
+    // Index of the calling worker in [0, size()), or -1 when called from outside any pool
+    static int current_worker() noexcept;
+
+private:
+    // Completion of one parallel_for call: its own task count and first exception, so
+    // concurrent callers neither wait for nor rethrow each other's tasks
+    struct Group {
+        explicit Group(int tasks) : left(tasks) {}
+        void finish(std::exception_ptr e) noexcept; // one task done (e: what it threw, or null)
+        void wait();                                // until all are done; rethrows the first e
+
+        std::mutex mu;
+        std::condition_variable cv;
+        int left;
+        std::exception_ptr error;
+    };
+
+    struct Queue {
+        std::mutex mu;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<Queue> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex mu_;                    // guards sleeping / completion waits
+    std::condition_variable work_cv_;  // workers wait for tasks
+    std::condition_variable idle_cv_;  // wait_idle() waits for pending_ == 0
+    std::atomic<int> queued_{0};       // tasks sitting in some deque
+    std::atomic<int> pending_{0};      // submitted but not yet finished
+    std::atomic<unsigned> next_{0};    // round-robin cursor for submit()
+    bool stop_ = false;
+    std::exception_ptr error_;
+
+    void worker_loop(int w, bool pin);
+    bool try_pop(int w, std::function<void()>& task);
+};
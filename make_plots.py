@@ -3,7 +3,11 @@
 Render ellipsoidal intersection benchmark results into paper-ready plots and LaTeX tables.
 
 Expected CSV schema (from C++ benchmark):
-    d,n,method,mean_ms,std_ms,num_trials
+    d,n,method,mean_ms,std_ms,num_trials,mean_iters,
+    p50_ms,p90_ms,p99_ms,min_ms,max_ms,mean_eps,max_abs_eps_dev,num_disagree
+
+The columns after mean_iters are optional (older CSVs lack them); the percentile plots
+and the agreement table are skipped when they are missing.
 """
 
 import pandas as pd
@@ -30,8 +34,21 @@ METHOD_ORDER = [
     "Raw-Cauchy",
     "LP-Seidel",
     "LP-Clarkson",
+    "Fixed-SLSQP",
+    "Fixed-PGD",
+    "Fixed-Cauchy",
+    "LP-Seidel-Cold",
+    "LP-Clarkson-Cold",
+    "Raw-Newton",
+    "Fixed-Newton",
+    "LP-Seidel-Newton",
+    "Raw-Portfolio",
 ]
 
+# Percentile / agreement columns written by newer benchmark_stats2 builds
+PERCENTILE_COLS = ["p50_ms", "p90_ms", "p99_ms", "min_ms", "max_ms"]
+AGREEMENT_COLS = ["mean_eps", "max_abs_eps_dev", "num_disagree"]
+
 # Output directories
 FIG_DIR = Path("figs")
 TABLE_DIR = Path("tables")
@@ -141,6 +158,43 @@ def plot_runtime_vs_d(df: pd.DataFrame, fixed_n: int, use_logy: bool = True):
     print(f"[INFO] Saved {out_path}")
 
 
+def plot_percentiles_vs_d(df: pd.DataFrame, fixed_n: int, use_logy: bool = True):
+    """
+    For a fixed n, plot median runtime vs d for all methods, shading the p50..p99 band.
+    Saves a single PDF figure.
+    """
+    if not set(PERCENTILE_COLS).issubset(df.columns):
+        return
+    subset = df[df["n"] == fixed_n].copy()
+    if subset.empty:
+        print(f"[WARN] No data for n={fixed_n}, skipping percentile plot.")
+        return
+
+    methods = [m for m in METHOD_ORDER if m in subset["method"].unique()]
+
+    plt.figure()
+    for m in methods:
+        sub_m = subset[subset["method"] == m].sort_values("d")
+        (line,) = plt.plot(sub_m["d"], sub_m["p50_ms"], marker="o", label=m)
+        plt.fill_between(sub_m["d"], sub_m["p50_ms"], sub_m["p99_ms"],
+                         color=line.get_color(), alpha=0.15)
+
+    if use_logy:
+        plt.yscale("log")
+
+    plt.xlabel(r"$d$ (dimension)")
+    plt.ylabel("Runtime (ms), p50 with p50--p99 band")
+    plt.title(fr"Runtime percentiles vs $d$ at fixed $n={fixed_n}$")
+    plt.grid(True, which="both", linestyle="--", alpha=0.3)
+    plt.legend()
+
+    out_path = FIG_DIR / f"percentiles_vs_d_n{fixed_n}.pdf"
+    plt.tight_layout()
+    plt.savefig(out_path)
+    plt.close()
+    print(f"[INFO] Saved {out_path}")
+
+
 def plot_heatmap_for_method(df: pd.DataFrame, method: str):
     """
     Heatmap of log10 mean runtime over the (n,d) grid for a single method.
@@ -300,6 +354,47 @@ def latex_table_fixed_n(df: pd.DataFrame, fixed_n: int, precision: int = 3):
     print(f"[INFO] Saved {out_path}")
 
 
+def latex_table_agreement(df: pd.DataFrame, precision: int = 2):
+    """
+    LaTeX table of every (d, n, method) whose eps* disagreed with the per-trial median
+    of all methods in at least one trial. Prints a warning per offending row.
+    """
+    if not set(AGREEMENT_COLS).issubset(df.columns):
+        return
+    bad = df[df["num_disagree"] > 0].copy()
+    out_path = TABLE_DIR / "eps_agreement.tex"
+    if bad.empty:
+        print("[INFO] All methods agree on eps* in every trial.")
+        out_path.unlink(missing_ok=True)
+        return
+
+    bad["rank"] = bad["method"].map({m: i for i, m in enumerate(METHOD_ORDER)})
+    bad = bad.sort_values(["d", "n", "rank"])
+    for _, r in bad.iterrows():
+        print(f"[WARN] d={r['d']} n={r['n']} {r['method']}: eps* off in "
+              f"{int(r['num_disagree'])}/{int(r['num_trials'])} trials "
+              f"(max |dev| = {r['max_abs_eps_dev']:.3g})")
+
+    table = pd.DataFrame({
+        "$d$": bad["d"],
+        "$n$": bad["n"],
+        "Method": bad["method"],
+        "Trials off": [f"{int(a)}/{int(b)}" for a, b in zip(bad["num_disagree"], bad["num_trials"])],
+        r"max $|\varepsilon - \mathrm{med}|$": [f"{v:.{precision}e}" for v in bad["max_abs_eps_dev"]],
+    })
+    latex_str = table.to_latex(
+        index=False,
+        escape=False,
+        caption=r"Trials where a method's $\varepsilon^*$ disagreed with the median over methods.",
+        label="tab:eps_agreement",
+        column_format="rrlrr",
+    )
+    with open(out_path, "w") as f:
+        f.write(latex_str)
+
+    print(f"[INFO] Saved {out_path}")
+
+
 # ----------------------------------------------------------------------
 # Main driver
 # ----------------------------------------------------------------------
@@ -314,6 +409,8 @@ def main():
         mean_ms=("mean_ms", "mean"),
         std_ms=("std_ms", "mean"),
         num_trials=("num_trials", "mean"),  # should already be constant
+        **{c: (c, "max" if c in ("max_ms", "max_abs_eps_dev") else "mean")
+           for c in PERCENTILE_COLS + AGREEMENT_COLS if c in df.columns},
     )
     # If df is already aggregated (one row per (d,n,method)), grouped == df
     df_ag = grouped
@@ -326,6 +423,10 @@ def main():
     for n in FIXED_N_FOR_D_SWEEPS:
         plot_runtime_vs_d(df_ag, fixed_n=n, use_logy=True)
 
+    # Percentile bands vs d for each fixed n (newer CSVs only)
+    for n in FIXED_N_FOR_D_SWEEPS:
+        plot_percentiles_vs_d(df_ag, fixed_n=n, use_logy=True)
+
     # Heatmaps per method
     for m in METHOD_ORDER:
         plot_heatmap_for_method(df_ag, method=m)
@@ -338,6 +439,9 @@ def main():
     for n in FIXED_N_FOR_D_SWEEPS:
         latex_table_fixed_n(df_ag, fixed_n=n, precision=3)
 
+    # Methods that disagreed on eps* (newer CSVs only)
+    latex_table_agreement(df_ag)
+
 
 if __name__ == "__main__":
     main()
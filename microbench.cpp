@@ -0,0 +1,809 @@
+#include "RandomEllipsoidGenerator.hpp"
+#include "Batch.hpp"
+#include "DynamicIntersection.hpp"
+#include "KFromEllipsoids.hpp"
+#include "LPClarkson.hpp"
+#include "LPSeidel.hpp"
+#include "LPType.hpp"
+#include "OracleCache.hpp"
+#include "PGD.hpp"
+#include "Simplex.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+// Heap allocation counter (calls and requested bytes). On glibc malloc itself is
+// interposed, which also sees Eigen's aligned_malloc and aligned_alloc; elsewhere only
+// operator new is counted.
+static std::atomic<long> g_allocs{0};
+static std::atomic<long> g_bytes{0};
+
+static void count_alloc(std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(static_cast<long>(n), std::memory_order_relaxed);
+}
+
+#if defined(__GLIBC__)
+extern "C" void* __libc_malloc(std::size_t);
+extern "C" void* __libc_calloc(std::size_t, std::size_t);
+extern "C" void* __libc_realloc(void*, std::size_t);
+extern "C" void* __libc_memalign(std::size_t, std::size_t);
+extern "C" void* malloc(std::size_t n) {
+    count_alloc(n);
+    return __libc_malloc(n);
+}
+extern "C" void* calloc(std::size_t c, std::size_t n) {
+    count_alloc(c * n);
+    return __libc_calloc(c, n);
+}
+extern "C" void* realloc(void* p, std::size_t n) {
+    count_alloc(n);
+    return __libc_realloc(p, n);
+}
+extern "C" void* aligned_alloc(std::size_t a, std::size_t n) {
+    count_alloc(n);
+    return __libc_memalign(a, n);
+}
+#else
+void* operator new(std::size_t n) {
+    count_alloc(n);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+#endif
+
+using Clock = std::chrono::high_resolution_clock;
+
+template <class F>
+double time_ns(F&& f) {
+    const auto t0 = Clock::now();
+    f();
+    const auto t1 = Clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count();
+}
+
+// The previous projection: copy into a std::vector and fully sort, O(k log k)
+static Eigen::VectorXd project_sort(const Eigen::VectorXd& z) {
+    const int k = static_cast<int>(z.size());
+    std::vector<double> u(z.data(), z.data() + k);
+    std::sort(u.begin(), u.end(), std::greater<double>());
+    double css = 0.0, theta = 0.0;
+    for (int i = 0; i < k; ++i) {
+        css += u[i];
+        const double t = (css - 1.0) / (i + 1);
+        if (i == k-1 || u[i+1] <= t) { theta = t; break; }
+    }
+    return (z.array() - theta).cwiseMax(0.0);
+}
+
+static void bench_projection() {
+    std::printf("simplex projection\n%8s %14s %14s %12s %12s %10s\n",
+                "k", "sort ns/op", "inplace ns/op", "sort alloc", "inpl alloc", "max |diff|");
+    std::mt19937_64 rng(7);
+    std::normal_distribution<double> N(0.0, 1.0);
+    for (int k : {8, 64, 1024, 16384, 262144}) {
+        const int reps = std::max(5, 4'000'000 / k);
+        Eigen::VectorXd z = Eigen::VectorXd::NullaryExpr(k, [&]() { return N(rng); });
+        Eigen::VectorXd x(k), ref;
+        Simplex::Workspace ws;
+        ws.reserve(k);
+
+        long a0 = g_allocs.load();
+        const double t_sort = time_ns([&]() {
+            for (int r = 0; r < reps; ++r) ref = project_sort(z);
+        });
+        const long a_sort = g_allocs.load() - a0;
+
+        a0 = g_allocs.load();
+        const double t_inpl = time_ns([&]() {
+            for (int r = 0; r < reps; ++r) { x = z; Simplex::project_to_simplex(x, ws); }
+        });
+        const long a_inpl = g_allocs.load() - a0;
+
+        std::printf("%8d %14.1f %14.1f %12.2f %12.2f %10.2e\n", k,
+                    t_sort / reps, t_inpl / reps,
+                    double(a_sort) / reps, double(a_inpl) / reps, (x - ref).cwiseAbs().maxCoeff());
+    }
+}
+
+static void bench_pgd() {
+    std::printf("\nPGD (d = 3, fixed 200 iterations)\n%8s %14s %14s %14s\n",
+                "k", "us/iter", "allocs/call", "allocs/iter");
+    for (int k : {16, 256, 4096}) {
+        RandomEllipsoidGenerator::Options opt;
+        opt.n = k;
+        opt.d = 3;
+        opt.store_covariance = false;
+        opt.seed = 11;
+        RandomEllipsoidGenerator gen(opt);
+        auto Es = gen.generate();
+        auto K = make_Kobjective_from_ellipsoids<3>(1.0, Es);
+
+        PGDOptions po;
+        po.max_iters = 200;
+        po.tol = 0.0; // never converge early: every call runs max_iters
+        const Eigen::VectorXd lam0 = Simplex::uniform_start(k);
+
+        minimize_pgd(K, lam0, po); // warm caches
+        const long a0 = g_allocs.load();
+        PGDResult res;
+        const double t = time_ns([&]() { res = minimize_pgd(K, lam0, po); });
+        const long allocs = g_allocs.load() - a0;
+
+        // A call pays a constant setup (buffers, result); the rest is per iteration
+        const long a1 = g_allocs.load();
+        po.max_iters = 100;
+        minimize_pgd(K, lam0, po);
+        const long allocs_half = g_allocs.load() - a1;
+
+        std::printf("%8d %14.2f %14ld %14.3f\n", k, t / res.iters / 1e3, allocs,
+                    double(allocs - allocs_half) / 100.0);
+    }
+}
+
+static void bench_violator_scan() {
+    std::printf("\nviolator scan (n = 100000)\n%8s %10s %14s %14s %14s %14s\n",
+                "d", "layout", "copy allocs", "generate ms", "scan ns/elem", "scan GB/s");
+    const int n = 100000;
+    for (int d : {3, 10, 30}) {
+        RandomEllipsoidGenerator::Options opt;
+        opt.n = n;
+        opt.d = d;
+        opt.store_covariance = false;
+        opt.seed = 3;
+
+        std::vector<Ellipsoid> Es;
+        const double t_vec = time_ns([&]() { Es = RandomEllipsoidGenerator(opt).generate(); });
+        EllipsoidSet set;
+        const double t_set = time_ns([&]() { set = RandomEllipsoidGenerator(opt).generate_set(); });
+        for (const auto& E : Es) E.precision_factor(); // both sides scan with the factor
+
+        // Heap blocks behind each container: a deep copy allocates one per block
+        long a0 = g_allocs.load();
+        long alloc_vec = 0, alloc_set = 0;
+        {
+            std::vector<Ellipsoid> copy;
+            copy.reserve(Es.size());
+            for (const auto& E : Es) copy.emplace_back(E.center(), std::nullopt, E.precision(), E.radius());
+            for (const auto& E : copy) E.precision_factor();
+            alloc_vec = g_allocs.load() - a0;
+        }
+        a0 = g_allocs.load();
+        { EllipsoidSet copy(set); alloc_set = g_allocs.load() - a0; }
+
+        const Eigen::VectorXd m = Eigen::VectorXd::Zero(d);
+        const double r2 = 4.0;
+        const double bytes = double(n) * (d + d * d) * sizeof(double); // what the kernel reads
+        const int reps = 5;
+
+        long hits_vec = 0;
+        const double s_vec = time_ns([&]() {
+            for (int r = 0; r < reps; ++r)
+                for (const auto& E : Es) hits_vec += E.mahalanobis2(m) > r2;
+        }) / reps;
+
+        EllipsoidLPOracle O(set, LPParams{});
+        const LPBasis B{{0}, 2.0};
+        const LPEval evB{2.0, m, Eigen::VectorXd(), Eigen::VectorXd()};
+        std::vector<int> all(n);
+        for (int i = 0; i < n; ++i) all[i] = i;
+        long hits_set = 0;
+        const double s_set = time_ns([&]() {
+            for (int r = 0; r < reps; ++r) hits_set += (long)O.violators(B, evB, all).size();
+        }) / reps;
+
+        std::printf("%8d %10s %14ld %14.1f %14.2f %14.2f\n", d, "vector", alloc_vec, t_vec / 1e6, s_vec / n, bytes / s_vec);
+        std::printf("%8d %10s %14ld %14.1f %14.2f %14.2f\n", d, "set", alloc_set, t_set / 1e6, s_set / n, bytes / s_set);
+        (void)hits_vec; (void)hits_set;
+    }
+}
+
+// LPParams::float_scan against the double scan, at a radius near the 90th percentile of
+// the distances (most candidates pass, as in the late rounds of a solve)
+static void bench_float_scan() {
+    std::printf("\nfloat violator scan\n%6s %8s %16s %16s %10s %12s %10s\n",
+                "d", "n", "double ns/elem", "float ns/elem", "speedup", "fallbacks", "same");
+    for (int d : {20, 50}) {
+        const int n = d == 20 ? 20000 : 4000;
+        RandomEllipsoidGenerator::Options opt;
+        opt.n = n;
+        opt.d = d;
+        opt.seed = 5;
+        const EllipsoidSet set = RandomEllipsoidGenerator(opt).generate_set();
+
+        LPParams pd, pf;
+        pf.float_scan = true;
+        const EllipsoidLPOracle Od(set, pd), Of(set, pf);
+        const Eigen::VectorXd m = set.center(0);
+        Eigen::VectorXd diff(d);
+        std::vector<double> d2(n);
+        for (int i = 0; i < n; ++i) d2[i] = mahalanobis2_lower(set.precision_factor(i), set.center(i), m, diff);
+        std::nth_element(d2.begin(), d2.begin() + 9 * n / 10, d2.end());
+        const double eps = std::sqrt(d2[9 * n / 10]) - pd.tight_tol;
+
+        const LPBasis B{{0}, eps};
+        const LPEval evB{eps, m, Eigen::VectorXd(), Eigen::VectorXd()};
+        std::vector<int> all(n);
+        std::iota(all.begin(), all.end(), 0);
+        const int reps = 10;
+        std::vector<int> vd, vf;
+        const double t_d = time_ns([&]() {
+            for (int r = 0; r < reps; ++r) vd = Od.violators(B, evB, all);
+        }) / reps;
+        const perf::Scope scope;
+        const double t_f = time_ns([&]() {
+            for (int r = 0; r < reps; ++r) vf = Of.violators(B, evB, all);
+        }) / reps;
+        const PerfCounters c = scope.delta();
+        std::printf("%6d %8d %16.2f %16.2f %10.2f %12lld %10s\n", d, n, t_d / n, t_f / n, t_d / t_f,
+                    c.float_fallbacks / reps, vd == vf ? "yes" : "NO");
+    }
+}
+
+// LPParams::spatial_index: violators_all (k-d tree query) against the full scan, at the
+// eps* of the solved instance, and whole Clarkson solves with and without the index
+static void bench_spatial_index() {
+    std::printf("\nspatial index violator query\n%4s %8s %10s %12s %12s %10s %14s %14s\n",
+                "d", "n", "build ms", "scan ms", "query ms", "violators", "Clarkson ms", "indexed ms");
+    const int n = 200000;
+    for (int d : {2, 3}) {
+        RandomEllipsoidGenerator::Options opt;
+        opt.n = n;
+        opt.d = d;
+        opt.seed = 13;
+        const EllipsoidSet set = RandomEllipsoidGenerator(opt).generate_set();
+        const LPParams lp{SolverKind::Newton, 1e-8};
+        LPParams lpi = lp;
+        lpi.spatial_index = true;
+        std::vector<int> S(n);
+        std::iota(S.begin(), S.end(), 0);
+
+        const EllipsoidLPOracle O(set, lp);
+        std::unique_ptr<EllipsoidLPOracle> Oi;
+        const double t_build = time_ns([&]() { Oi = std::make_unique<EllipsoidLPOracle>(set, lpi); });
+        ClarksonResult r, ri;
+        const double t_cl = time_ns([&]() { r = clarkson_iterative(O, S); });
+        const double t_cli = time_ns([&]() { ri = clarkson_iterative(*Oi, S); });
+
+        const LPEval ev = O.evaluate(r.basis.idx);
+        const int reps = 10;
+        std::vector<int> vs, vq;
+        const double t_scan = time_ns([&]() {
+            for (int k = 0; k < reps; ++k) vs = O.violators(r.basis, ev, S);
+        }) / reps;
+        const double t_query = time_ns([&]() {
+            for (int k = 0; k < reps; ++k) vq = Oi->violators_all(r.basis, ev);
+        }) / reps;
+        std::printf("%4d %8d %10.1f %12.3f %12.3f %10zu %14.1f %14.1f%s\n", d, n, t_build / 1e6, t_scan / 1e6,
+                    t_query / 1e6, vs.size(), t_cl / 1e6, t_cli / 1e6,
+                    vs == vq && r.basis.idx == ri.basis.idx ? "" : "  MISMATCH");
+    }
+}
+
+// Objective over a k-subset plus one value_grad, as on an oracle cache miss: the old
+// gather into per-index vectors, against a view over the set with a reused workspace
+static void bench_subset_objective() {
+    std::printf("\nsubset objective build + value_grad (n = 4096)\n%8s %8s %10s %14s %14s\n",
+                "d", "k", "path", "ns/build", "allocs/build");
+    const int n = 4096, reps = 2000;
+    for (int d : {3, 10}) {
+        RandomEllipsoidGenerator::Options opt;
+        opt.n = n;
+        opt.d = d;
+        opt.store_covariance = false;
+        opt.seed = 5;
+        const EllipsoidSet set = RandomEllipsoidGenerator(opt).generate_set();
+        std::mt19937_64 rng(9);
+        std::uniform_int_distribution<int> pick(0, n - 1);
+        for (int k : {4, 16, 64}) {
+            std::vector<std::vector<int>> subsets(64, std::vector<int>(k));
+            for (auto& S : subsets) for (int& i : S) i = pick(rng);
+            const Eigen::VectorXd lam = Simplex::uniform_start(k);
+            Eigen::VectorXd g(k);
+
+            auto gather = [&](const std::vector<int>& S) {
+                std::vector<Eigen::VectorXd> xs; xs.reserve(k);
+                std::vector<Eigen::MatrixXd> Ainv; Ainv.reserve(k);
+                std::vector<Eigen::MatrixXd> Ls; Ls.reserve(k);
+                for (int i : S) {
+                    xs.emplace_back(set.center(i));
+                    Ainv.emplace_back(set.precision(i));
+                    Ls.emplace_back(set.precision_factor(i));
+                }
+                KObjective K(1.0, xs, Ainv, Ls);
+                return K.value_grad(lam, g);
+            };
+            KObjective::Workspace ws;
+            auto view = [&](const std::vector<int>& S) {
+                KObjective K(1.0, set, S, &ws);
+                return K.value_grad(lam, g);
+            };
+
+            double sink = view(subsets[0]); // size the workspace
+            long a0 = g_allocs.load();
+            const double t_gather = time_ns([&]() { for (int r = 0; r < reps; ++r) sink += gather(subsets[r % 64]); });
+            const long a_gather = g_allocs.load() - a0;
+            a0 = g_allocs.load();
+            const double t_view = time_ns([&]() { for (int r = 0; r < reps; ++r) sink += view(subsets[r % 64]); });
+            const long a_view = g_allocs.load() - a0;
+
+            std::printf("%8d %8d %10s %14.1f %14.2f\n", d, k, "gather", t_gather / reps, double(a_gather) / reps);
+            std::printf("%8d %8d %10s %14.1f %14.2f\n", d, k, "view", t_view / reps, double(a_view) / reps);
+            (void)sink;
+        }
+    }
+}
+
+// k = 2: optimal_radius takes the closed form (KObjectiveT::solve_pair); the iterative
+// Newton solve it replaces, with the same tolerance as optimal_radius, for comparison
+static void bench_pair() {
+    std::printf("\ntwo-ellipsoid solve (256 pairs)\n%6s %14s %14s %10s %16s\n",
+                "d", "us closed", "us Newton", "speedup", "max |eps diff|");
+    const int pairs = 256;
+    for (int d : {2, 3, 10, 20, 50}) {
+        RandomEllipsoidGenerator::Options opt;
+        opt.n = 2 * pairs;
+        opt.d = d;
+        opt.seed = 29;
+        const EllipsoidSet set = RandomEllipsoidGenerator(opt).generate_set();
+        std::vector<std::array<int, 2>> idx(pairs);
+        for (int p = 0; p < pairs; ++p) idx[p] = {2 * p, 2 * p + 1};
+        KObjective::Workspace ws;
+        std::vector<double> closed(pairs), newton(pairs);
+
+        const double t_closed = time_ns([&]() {
+            for (int p = 0; p < pairs; ++p) {
+                KObjective K(1.0, set, idx[p], &ws);
+                closed[p] = optimal_radius(K, SolverKind::Newton).eps_star;
+            }
+        });
+        const double t_newton = time_ns([&]() {
+            NewtonOptions o;
+            o.max_iters = 100;
+            o.tol = 1e-12;
+            Eigen::VectorXd g(2);
+            for (int p = 0; p < pairs; ++p) {
+                KObjective K(1.0, set, idx[p], &ws);
+                const auto res = minimize_newton(K, Simplex::uniform_start(2), o);
+                K.value_grad(res.lambda, g);
+                newton[p] = K.mahalanobis_d2().maxCoeff();
+            }
+        });
+        double maxdiff = 0.0;
+        for (int p = 0; p < pairs; ++p) maxdiff = std::max(maxdiff, std::abs(closed[p] - std::sqrt(newton[p])));
+        std::printf("%6d %14.2f %14.2f %10.2f %16.2e\n", d, t_closed / pairs / 1e3, t_newton / pairs / 1e3,
+                    t_newton / t_closed, maxdiff);
+    }
+}
+
+// Many small independent instances: a plain loop over optimal_radius / seidel_incremental
+// against the batch API on a one-worker pool (same thread count, so the difference is the
+// reused scratch, not parallelism)
+static void bench_batch() {
+    std::printf("\nbatch of 2000 instances (k in 3..8, mixed d)\n%10s %10s %14s %16s\n",
+                "solver", "path", "us/instance", "allocs/instance");
+    std::vector<std::vector<Ellipsoid>> sets;
+    std::mt19937_64 rng(17);
+    for (int i = 0; i < 2000; ++i) {
+        RandomEllipsoidGenerator::Options opt;
+        opt.n = 3 + static_cast<int>(rng() % 6);
+        opt.d = std::array<int, 3>{2, 3, 10}[rng() % 3];
+        opt.store_covariance = false;
+        opt.seed = rng();
+        sets.push_back(RandomEllipsoidGenerator(opt).generate());
+        for (const auto& E : sets.back()) (void)E.precision_factor(); // cached up front
+    }
+    std::vector<BatchInstance> batch;
+    for (const auto& s : sets) batch.push_back(BatchInstance{s});
+    WorkStealingPool pool(WorkStealingPool::Options{1});
+    BatchOptions bo;
+    bo.pool = &pool;
+    const double n = static_cast<double>(sets.size());
+
+    auto row = [&](const char* solver, const char* path, auto&& f) {
+        f(); // warm caches and scratch
+        const long a0 = g_allocs.load();
+        const double t = time_ns(f);
+        std::printf("%10s %10s %14.2f %16.1f\n", solver, path, t / n / 1e3, double(g_allocs.load() - a0) / n);
+    };
+    double sink = 0.0;
+    row("PGD", "loop", [&]() { for (const auto& s : sets) sink += optimal_radius(s, SolverKind::PGD).eps_star; });
+    row("PGD", "batch", [&]() { for (const auto& r : optimal_radius_batch(batch, SolverKind::PGD, bo)) sink += r.eps_star; });
+    row("Newton", "loop", [&]() { for (const auto& s : sets) sink += optimal_radius(s, SolverKind::Newton).eps_star; });
+    row("Newton", "batch", [&]() { for (const auto& r : optimal_radius_batch(batch, SolverKind::Newton, bo)) sink += r.eps_star; });
+    const LPParams lp{SolverKind::Newton, 1e-8};
+    row("Seidel", "loop", [&]() {
+        for (const auto& s : sets) {
+            EllipsoidLPOracle O(s, s[0].dim(), lp);
+            std::vector<int> S(s.size());
+            std::iota(S.begin(), S.end(), 0);
+            sink += seidel_incremental(O, S).basis.eps_star;
+        }
+    });
+    row("Seidel", "batch", [&]() { for (const auto& r : seidel_batch(batch, lp, {}, bo)) sink += r.basis.eps_star; });
+    (void)sink;
+}
+
+// Sliding window of W ellipsoids (one insert + one erase per step): DynamicIntersection
+// against rebuilding the oracle and re-running seidel_incremental on the window
+static void bench_dynamic() {
+    std::printf("\nsliding window, insert + erase per step\n%6s %8s %16s %16s %12s\n",
+                "d", "W", "us/step dynamic", "us/step resolve", "resolves");
+    for (int d : {3, 10}) {
+        const int W = 2000, steps = 4000;
+        RandomEllipsoidGenerator::Options opt;
+        opt.n = W + steps;
+        opt.d = d;
+        opt.store_covariance = false;
+        opt.seed = 23;
+        const auto Es = RandomEllipsoidGenerator(opt).generate();
+        const LPParams lp{SolverKind::Newton, 1e-8};
+
+        DynamicIntersection D(d, DynamicIntersection::Options{lp, 1});
+        std::vector<DynamicIntersection::Id> ids;
+        for (int i = 0; i < W; ++i) ids.push_back(D.insert(Es[i]));
+        const long long r0 = D.stats().resolves;
+        double sink = 0.0;
+        const double t_dyn = time_ns([&]() {
+            for (int t = 0; t < steps; ++t) {
+                D.erase(ids[t]);
+                ids.push_back(D.insert(Es[W + t]));
+                sink += D.eps_star();
+            }
+        });
+
+        const int full_steps = 50; // a full re-solve per step is far slower; sample a few
+        std::vector<int> S(W);
+        std::iota(S.begin(), S.end(), 0);
+        const double t_full = time_ns([&]() {
+            for (int t = 0; t < full_steps; ++t) {
+                const std::vector<Ellipsoid> window(Es.begin() + t + 1, Es.begin() + t + 1 + W);
+                EllipsoidLPOracle O(window, d, lp);
+                sink += seidel_incremental(O, S).basis.eps_star;
+            }
+        });
+        std::printf("%6d %8d %16.2f %16.2f %12lld\n", d, W, t_dyn / steps / 1e3, t_full / full_steps / 1e3,
+                    D.stats().resolves - r0);
+        (void)sink;
+    }
+}
+
+// Regression check for warm-started oracle solves: Seidel over many orders of small
+// instances, each inner solver warm and cold, against optimal_radius on the whole set.
+// Returns the number of runs whose eps* is off by more than 1e-5 relative.
+static int check_warm_start() {
+    const int instances = 20, orders = 100, n = 8;
+    std::printf("\nwarm-start check: Seidel, d = 2, n = %d, %d instances x %d orders\n%10s %8s %8s %14s\n",
+                n, instances, orders, "solver", "start", "wrong", "max rel err");
+    std::vector<std::vector<Ellipsoid>> sets;
+    std::vector<double> ref;
+    for (int s = 0; s < instances; ++s) {
+        RandomEllipsoidGenerator::Options opt;
+        opt.n = n;
+        opt.d = 2;
+        opt.store_covariance = false;
+        opt.seed = static_cast<uint64_t>(s);
+        sets.push_back(RandomEllipsoidGenerator(opt).generate());
+        ref.push_back(optimal_radius(sets.back(), SolverKind::Newton).eps_star);
+    }
+    std::vector<int> S(n);
+    std::iota(S.begin(), S.end(), 0);
+
+    int total = 0;
+    const std::array<std::pair<SolverKind, const char*>, 3> kinds{
+        {{SolverKind::PGD, "PGD"}, {SolverKind::Cauchy, "Cauchy"}, {SolverKind::Newton, "Newton"}}};
+    for (const auto& [kind, name] : kinds) {
+        for (bool warm : {true, false}) {
+            int wrong = 0;
+            double maxerr = 0.0;
+            for (int i = 0; i < instances; ++i) {
+                for (int order = 0; order < orders; ++order) {
+                    LPParams lp{kind, 1e-8};
+                    lp.warm_start = warm;
+                    EllipsoidLPOracle O(sets[i], 2, lp);
+                    SeidelOptions so;
+                    so.seed = static_cast<uint64_t>(order);
+                    const double err = std::abs(seidel_incremental(O, S, so).basis.eps_star - ref[i]) / ref[i];
+                    maxerr = std::max(maxerr, err);
+                    wrong += err > 1e-5;
+                }
+            }
+            std::printf("%10s %8s %8d %14.2e\n", name, warm ? "warm" : "cold", wrong, maxerr);
+            total += wrong;
+        }
+    }
+    return total;
+}
+
+// Regression check for Newton at large k, where many indices must leave the support:
+// it has to converge and agree with PGD. Returns the number of failing rows.
+static int check_newton_large_k() {
+    std::printf("\nNewton check, d = 10\n%6s %14s %14s %8s %10s %12s\n",
+                "k", "eps PGD", "eps Newton", "iters", "converged", "rel diff");
+    int failed = 0;
+    for (int k : {100, 300, 1000}) {
+        RandomEllipsoidGenerator::Options opt;
+        opt.n = k;
+        opt.d = 10;
+        opt.seed = 42;
+        const auto Es = RandomEllipsoidGenerator(opt).generate();
+        const EpsStar pgd = optimal_radius(Es, SolverKind::PGD);
+        const EpsStar newton = optimal_radius(Es, SolverKind::Newton);
+        const double rel = std::abs(newton.eps_star - pgd.eps_star) / pgd.eps_star;
+        std::printf("%6d %14.8f %14.8f %8d %10s %12.2e\n", k, pgd.eps_star, newton.eps_star, newton.iters,
+                    newton.converged ? "yes" : "no", rel);
+        failed += !newton.converged || rel > 1e-6;
+    }
+    return failed;
+}
+
+// ---------------------------------------------------------------------------------
+// Kernel suite: each hot primitive on its own over a (k, d) grid, with warmup and
+// repetitions, reported as ns/op, allocations and bytes per op, and GFLOP/s where the
+// kernel has a well-defined flop count.
+
+struct SuiteOptions {
+    int warmup = 3;          // untimed repetitions before measuring
+    int reps = 10;           // timed repetitions; ns/op is their median
+    double rep_ms = 2.0;     // target length of one repetition (sets ops per rep)
+    std::string filter;      // run only kernels whose name contains this
+    std::string csv, json;   // machine-readable output, when set
+    bool compare = true;     // also run the comparison tables above
+};
+
+struct KernelRecord {
+    std::string kernel;
+    int k = 0, d = 0;
+    int reps = 0;
+    long ops_per_rep = 0;
+    double ns_median = 0, ns_min = 0;
+    double allocs = 0, bytes = 0; // per op
+    double gflops = 0;            // 0 when no flop model
+};
+
+static std::vector<KernelRecord> g_records;
+static volatile double g_sink = 0.0; // keeps results observable
+
+// op() runs the kernel once and returns something data-dependent; flops is per op
+// (0: no model). The first call is outside the timing, so lazily sized scratch is warm.
+template <class F>
+static void run_kernel(const SuiteOptions& o, const std::string& name, int k, int d,
+                       double flops, F&& op) {
+    if (!o.filter.empty() && name.find(o.filter) == std::string::npos) return;
+    double sink = op();
+
+    long ops = 1;
+    while (ops < (1L << 30)) {
+        const double t = time_ns([&]() { for (long i = 0; i < ops; ++i) sink += op(); });
+        if (t >= o.rep_ms * 1e6) break;
+        ops = t > 0 ? std::max(2 * ops, static_cast<long>(ops * o.rep_ms * 1e6 / t)) : 2 * ops;
+    }
+    for (int w = 0; w < o.warmup; ++w)
+        for (long i = 0; i < ops; ++i) sink += op();
+
+    std::vector<double> ns(std::max(1, o.reps));
+    const long a0 = g_allocs.load(), b0 = g_bytes.load();
+    for (double& t : ns)
+        t = time_ns([&]() { for (long i = 0; i < ops; ++i) sink += op(); }) / ops;
+    const double total = double(ops) * ns.size();
+    const double allocs = (g_allocs.load() - a0) / total;
+    const double bytes = (g_bytes.load() - b0) / total;
+    (void)sink;
+
+    std::sort(ns.begin(), ns.end());
+    KernelRecord r{name, k, d, static_cast<int>(ns.size()), ops, ns[ns.size() / 2], ns.front(),
+                   allocs, bytes, flops > 0 ? flops / ns[ns.size() / 2] : 0.0};
+    std::printf("%-22s %6d %4d %12.1f %12.1f %10.2f %12.1f", r.kernel.c_str(), k, d,
+                r.ns_median, r.ns_min, r.allocs, r.bytes);
+    if (r.gflops > 0) std::printf(" %9.3f\n", r.gflops);
+    else std::printf(" %9s\n", "-");
+    g_records.push_back(std::move(r));
+}
+
+static RandomEllipsoidGenerator::Options suite_instance(int n, int d) {
+    RandomEllipsoidGenerator::Options opt;
+    opt.n = n;
+    opt.d = d;
+    opt.store_covariance = false;
+    opt.seed = 1000u + 31u * n + d;
+    return opt;
+}
+
+// Flop models: S += λ_i A_i^{-1} and mu += λ_i A_i^{-1} x_i per index, then the d×d
+// Cholesky and two triangular solves; distances add (m - x_j), L_j^T·diff and a norm
+static double flops_value(double k, double d) { return k * (2 * d * d + 2 * d + 2) + d * d * d / 3 + 2 * d * d + 2 * d; }
+static double flops_dist(double k, double d) { return k * (d * d + 4 * d); }
+
+template <int D>
+static void suite_objective(const SuiteOptions& o, const EllipsoidSet& set, int k, const char* tag) {
+    const int d = set.d();
+    std::vector<int> idx(k);
+    for (int i = 0; i < k; ++i) idx[i] = i;
+    KObjectiveT<D> K(1.0, set, idx);
+
+    std::mt19937_64 rng(17);
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    Eigen::VectorXd lam = Eigen::VectorXd::NullaryExpr(k, [&]() { return U(rng); });
+    lam /= lam.sum();
+    Eigen::VectorXd g(k), v = Eigen::VectorXd::Ones(k), hv(k);
+    const std::string t = tag;
+
+    run_kernel(o, "value" + t, k, d, flops_value(k, d), [&]() { return K.value(lam); });
+    run_kernel(o, "value_grad" + t, k, d, flops_value(k, d) + flops_dist(k, d),
+               [&]() { return K.value_grad(lam, g); });
+    if (k <= 512) {
+        Eigen::MatrixXd H(k, k);
+        // + R (k matrix-vector products), S^{-1} R (2 d^2 per column), R^T Y (2 k^2 d)
+        const double fh = flops_value(k, d) + flops_dist(k, d) + k * (2.0 * d * d + d) +
+                          2.0 * k * d * d + 2.0 * k * k * d + double(k) * k;
+        run_kernel(o, "value_grad_hess" + t, k, d, fh, [&]() { return K.value_grad_hess(lam, g, H); });
+    }
+    // Steady state: R is built by the first product at this λ and reused afterwards
+    K.value_grad(lam, g);
+    run_kernel(o, "hess_vec" + t, k, d, 4.0 * k * d + 2.0 * d * d + k,
+               [&]() { K.hess_vec(v, hv); return hv[0]; });
+}
+
+static void run_suite(const SuiteOptions& o) {
+    std::printf("kernel suite (warmup %d, reps %d, %.1f ms/rep)\n%-22s %6s %4s %12s %12s %10s %12s %9s\n",
+                o.warmup, o.reps, o.rep_ms, "kernel", "k", "d", "ns/op med", "ns/op min",
+                "allocs/op", "bytes/op", "GFLOP/s");
+    const int ks[] = {8, 64, 512, 4096};
+    const int ds[] = {2, 3, 10, 30};
+
+    // Objective kernels; fixed-size instantiations too where they exist
+    for (int d : ds) {
+        const EllipsoidSet set = RandomEllipsoidGenerator(suite_instance(4096, d)).generate_set();
+        for (int k : ks) {
+            suite_objective<Eigen::Dynamic>(o, set, k, "");
+            if (d <= kMaxFixedDim)
+                dispatch_dim(d, [&](auto dim) {
+                    if constexpr (decltype(dim)::value != Eigen::Dynamic)
+                        suite_objective<decltype(dim)::value>(o, set, k, "/fixed");
+                });
+        }
+    }
+
+    // Simplex projection (d does not apply)
+    for (int k : ks) {
+        std::mt19937_64 rng(7);
+        std::normal_distribution<double> N(0.0, 1.0);
+        const Eigen::VectorXd z = Eigen::VectorXd::NullaryExpr(k, [&]() { return N(rng); });
+        Eigen::VectorXd x(k);
+        Simplex::Workspace ws;
+        ws.reserve(k);
+        run_kernel(o, "project_to_simplex", k, 0, 0.0,
+                   [&]() { x = z; Simplex::project_to_simplex(x, ws); return x[0]; });
+    }
+
+    // Cache keys for basis-sized sets (k = d + 2), and a lookup hit
+    for (int d : ds) {
+        const int k = d + 2;
+        std::vector<int> B(k);
+        for (int i = 0; i < k; ++i) B[i] = (i * 7919) % 100003;
+        run_kernel(o, "index_key", k, d, 0.0,
+                   [&]() { IndexKey key(B); return static_cast<double>(key.hash() & 1); });
+        OracleCache cache(OracleCache::Options{});
+        cache.insert(IndexKey(B), CacheVal{1.0, Eigen::VectorXd::Zero(d), Eigen::VectorXd::Zero(k)});
+        CacheVal cv;
+        run_kernel(o, "cache_find", k, d, 0.0,
+                   [&]() { return cache.find(IndexKey(B), cv) ? cv.eps_star : 0.0; });
+    }
+
+    // Violation tests against a fixed basis: one scan of k candidates, and single calls
+    for (int d : ds) {
+        const EllipsoidSet set = RandomEllipsoidGenerator(suite_instance(4096, d)).generate_set();
+        const EllipsoidLPOracle O(set, LPParams{});
+        const LPBasis B{{0}, 2.0};
+        const LPEval evB{2.0, Eigen::VectorXd::Zero(d), Eigen::VectorXd(), Eigen::VectorXd()};
+        for (int k : ks) {
+            std::vector<int> cand(k);
+            for (int i = 0; i < k; ++i) cand[i] = i;
+            run_kernel(o, "violators", k, d, flops_dist(k, d),
+                       [&]() { return static_cast<double>(O.violators(B, evB, cand).size()); });
+        }
+        int i = 0;
+        run_kernel(o, "is_violator", 1, d, flops_dist(1, d),
+                   [&]() { i = (i + 1) & 4095; return O.is_violator(B, i, evB) ? 1.0 : 0.0; });
+    }
+}
+
+static void write_csv(const std::string& path) {
+    std::ofstream f(path);
+    if (!f) throw std::runtime_error("cannot write " + path);
+    f << "kernel,k,d,reps,ops_per_rep,ns_per_op_median,ns_per_op_min,allocs_per_op,bytes_per_op,gflops\n";
+    for (const auto& r : g_records)
+        f << r.kernel << ',' << r.k << ',' << r.d << ',' << r.reps << ',' << r.ops_per_rep << ','
+          << r.ns_median << ',' << r.ns_min << ',' << r.allocs << ',' << r.bytes << ',' << r.gflops << '\n';
+}
+
+static void write_json(const std::string& path) {
+    std::ofstream f(path);
+    if (!f) throw std::runtime_error("cannot write " + path);
+    f << "[\n";
+    for (size_t i = 0; i < g_records.size(); ++i) {
+        const auto& r = g_records[i];
+        f << "  {\"kernel\": \"" << r.kernel << "\", \"k\": " << r.k << ", \"d\": " << r.d
+          << ", \"reps\": " << r.reps << ", \"ops_per_rep\": " << r.ops_per_rep
+          << ", \"ns_per_op_median\": " << r.ns_median << ", \"ns_per_op_min\": " << r.ns_min
+          << ", \"allocs_per_op\": " << r.allocs << ", \"bytes_per_op\": " << r.bytes
+          << ", \"gflops\": " << r.gflops << '}' << (i + 1 < g_records.size() ? "," : "") << '\n';
+    }
+    f << "]\n";
+}
+
+static void usage(const char* prog) {
+    std::cerr << "usage: " << prog << " [--warmup N] [--reps N] [--rep-ms X] [--filter NAME]"
+                                      " [--csv FILE] [--json FILE] [--no-compare]\n"
+              << "  --warmup N    untimed repetitions per kernel (default 3)\n"
+              << "  --reps N      timed repetitions per kernel; ns/op is the median (default 10)\n"
+              << "  --rep-ms X    target duration of one repetition (default 2)\n"
+              << "  --filter NAME run only kernels whose name contains NAME\n"
+              << "  --csv FILE    write the kernel results as CSV\n"
+              << "  --json FILE   write the kernel results as JSON\n"
+              << "  --no-compare  skip the layout / algorithm comparison tables\n";
+}
+
+int main(int argc, char** argv) {
+    SuiteOptions o;
+    for (int a = 1; a < argc; ++a) {
+        const std::string arg = argv[a];
+        auto value = [&]() -> std::string {
+            if (a + 1 >= argc) { usage(argv[0]); std::exit(2); }
+            return argv[++a];
+        };
+        if (arg == "--warmup") o.warmup = std::max(0, std::atoi(value().c_str()));
+        else if (arg == "--reps") o.reps = std::max(1, std::atoi(value().c_str()));
+        else if (arg == "--rep-ms") o.rep_ms = std::max(0.01, std::atof(value().c_str()));
+        else if (arg == "--filter") o.filter = value();
+        else if (arg == "--csv") o.csv = value();
+        else if (arg == "--json") o.json = value();
+        else if (arg == "--no-compare") o.compare = false;
+        else { usage(argv[0]); return 2; }
+    }
+
+    run_suite(o);
+    if (!o.csv.empty()) write_csv(o.csv);
+    if (!o.json.empty()) write_json(o.json);
+
+    if (o.compare) {
+        std::printf("\n");
+        bench_projection();
+        bench_pgd();
+        bench_violator_scan();
+        bench_float_scan();
+        bench_spatial_index();
+        bench_subset_objective();
+        bench_pair();
+        bench_batch();
+        bench_dynamic();
+        int failed = 0;
+        if (check_warm_start() > 0) {
+            std::fprintf(stderr, "warm-start check failed\n");
+            ++failed;
+        }
+        if (check_newton_large_k() > 0) {
+            std::fprintf(stderr, "Newton check failed\n");
+            ++failed;
+        }
+        if (failed) return 1;
+    }
+    return 0;
+}
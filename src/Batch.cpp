@@ -0,0 +1,134 @@
+#include "Batch.hpp"
+#include "FixedDim.hpp"
+#include "KObjective.hpp"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+
+WorkStealingPool& shared_pool() {
+    static WorkStealingPool pool(WorkStealingPool::Options{});
+    return pool;
+}
+
+void validate(std::span<const BatchInstance> instances) {
+    for (size_t i = 0; i < instances.size(); ++i) {
+        const BatchInstance& I = instances[i];
+        if (I.k() == 0) throw std::invalid_argument("batch: instance " + std::to_string(i) + " is empty");
+        if (I.set) continue;
+        const int d = I.d();
+        for (const Ellipsoid& E : I.ellipsoids) {
+            if (E.dim() != d)
+                throw std::invalid_argument("batch: instance " + std::to_string(i) + " mixes dimensions");
+        }
+    }
+}
+
+// Runs f(i) for every instance on the pool, grain consecutive instances per task. With
+// bucketing the instances are visited in (d, k) order, so a task (and mostly a worker)
+// sees one shape after another and its scratch never regrows.
+template <class F>
+void for_each_instance(std::span<const BatchInstance> instances, const BatchOptions& opt, F&& f) {
+    validate(instances);
+    const int n = static_cast<int>(instances.size());
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    if (opt.bucket) {
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            return std::pair(instances[a].d(), instances[a].k()) < std::pair(instances[b].d(), instances[b].k());
+        });
+    }
+    WorkStealingPool& pool = opt.pool ? *opt.pool : shared_pool();
+    const int grain = opt.grain > 0 ? opt.grain : std::max(1, n / (8 * pool.size()));
+    pool.parallel_for(0, n, [&](int t) { f(order[t]); }, grain);
+}
+
+// Per-thread packed copies of a span instance's centers, precisions and factors
+KSource gather_source(const BatchInstance& I) {
+    thread_local std::vector<double> X, P, L; // grow-only
+    const int k = I.k(), d = I.d();
+    const size_t dd = static_cast<size_t>(d) * d;
+    if (X.size() < static_cast<size_t>(k) * d) X.resize(static_cast<size_t>(k) * d);
+    if (P.size() < k * dd) { P.resize(k * dd); L.resize(k * dd); }
+    for (int j = 0; j < k; ++j) {
+        const Ellipsoid& E = I.ellipsoids[j];
+        Eigen::Map<Eigen::VectorXd>(X.data() + j * static_cast<size_t>(d), d) = E.center();
+        Eigen::Map<Eigen::MatrixXd>(P.data() + j * dd, d, d) = E.precision();
+        Eigen::Map<Eigen::MatrixXd>(L.data() + j * dd, d, d) = E.precision_factor();
+    }
+    KSource src;
+    src.n = k;
+    src.d = d;
+    src.centers = X.data();    src.center_stride = static_cast<size_t>(d);
+    src.precisions = P.data(); src.precision_stride = dd;
+    src.factors = L.data();    src.factor_stride = dd;
+    return src;
+}
+
+template <int D>
+EpsStar solve_one(const BatchInstance& I, SolverKind solver) {
+    thread_local typename KObjectiveT<D>::Workspace ws;
+    if (I.set) {
+        KObjectiveT<D> K(I.epsilon, *I.set, {}, &ws);
+        return optimal_radius(K, solver);
+    }
+    KObjectiveT<D> K(I.epsilon, gather_source(I), {}, &ws);
+    return optimal_radius(K, solver);
+}
+
+// run(oracle, S) on an oracle over all of I, S = {0..k-1}
+template <class Run>
+auto solve_lp_one(const BatchInstance& I, const LPParams& params, Run&& run) {
+    thread_local std::vector<int> S;
+    S.resize(I.k());
+    std::iota(S.begin(), S.end(), 0);
+    if (I.set) {
+        const EllipsoidLPOracle O(*I.set, params);
+        return run(O, S);
+    }
+    const EllipsoidLPOracle O(I.ellipsoids, I.d(), params);
+    return run(O, S);
+}
+
+} // namespace
+
+std::vector<EpsStar> optimal_radius_batch(std::span<const BatchInstance> instances,
+                                          SolverKind solver, const BatchOptions& opt) {
+    std::vector<EpsStar> out(instances.size());
+    for_each_instance(instances, opt, [&](int i) {
+        out[i] = dispatch_dim(instances[i].d(), [&](auto dim) {
+            return solve_one<decltype(dim)::value>(instances[i], solver);
+        });
+    });
+    return out;
+}
+
+std::vector<SeidelResult> seidel_batch(std::span<const BatchInstance> instances,
+                                       const LPParams& params, const SeidelOptions& so,
+                                       const BatchOptions& opt) {
+    std::vector<SeidelResult> out(instances.size());
+    for_each_instance(instances, opt, [&](int i) {
+        out[i] = solve_lp_one(instances[i], params, [&](const EllipsoidLPOracle& O, const std::vector<int>& S) {
+            return seidel_incremental(O, S, so);
+        });
+    });
+    return out;
+}
+
+std::vector<ClarksonResult> clarkson_batch(std::span<const BatchInstance> instances,
+                                           const LPParams& params, const ClarksonOptions& co,
+                                           const BatchOptions& opt) {
+    ClarksonOptions serial = co;
+    serial.threads = 1; // already on a pool worker
+    serial.pool = nullptr;
+    std::vector<ClarksonResult> out(instances.size());
+    for_each_instance(instances, opt, [&](int i) {
+        out[i] = solve_lp_one(instances[i], params, [&](const EllipsoidLPOracle& O, const std::vector<int>& S) {
+            return clarkson_iterative(O, S, serial);
+        });
+    });
+    return out;
+}
@@ -46,7 +46,14 @@ static inline void zero_clip_and_renorm(Eigen::VectorXd& w,
     }
 }
 
-CSResult minimize_cauchy_simplex(KObjective& obj,
+// Frank-Wolfe gap w·g - min_i g_i: bounds f(w) - f* and, unlike the tests on the support,
+// sees coordinates that were clipped to zero but should enter
+static inline double fw_gap(const Eigen::VectorXd& w, const Eigen::VectorXd& g) {
+    return dot(w, g) - g.minCoeff();
+}
+
+template <class Obj>
+CSResult minimize_cauchy_simplex(Obj& obj,
                                  const Eigen::VectorXd& w0,
                                  const CSOptions& opt)
 {
@@ -61,22 +68,50 @@ CSResult minimize_cauchy_simplex(KObjective& obj,
     Vec g; g.resize(w.size());
     double f = obj.value_grad(w, g);
 
+    // At a stop (w, g current): Certified when the gap allows it, else reseed and go on
+    enum class Stop { Certified, Reseeded, Exhausted };
+    int reseeds = 0;
+    Vec w_fw(w.size());
+    auto at_stop = [&]() {
+        int j = 0;
+        const double gmin = g.minCoeff(&j);
+        const double gap = fw_gap(w, g);
+        if (gap <= opt.gap_tol * std::max(1.0, std::abs(gmin))) return Stop::Certified;
+        if (reseeds == opt.max_reseeds) return Stop::Exhausted;
+        ++reseeds;
+        // Frank-Wolfe step w + γ (e_j - w) toward the coordinate that most wants to enter
+        // (slope -gap), backtracking from γ = 1 until it decreases f
+        for (double gamma = 1.0; gamma > 1e-16; gamma *= opt.armijo_beta) {
+            w_fw = (1.0 - gamma) * w;
+            w_fw[j] += gamma;
+            const double f_fw = obj.value(w_fw);
+            if (f_fw <= f - opt.armijo_c * gamma * gap) { w.swap(w_fw); break; }
+        }
+        f = obj.value_grad(w, g);
+        return Stop::Reseeded;
+    };
+
     Vec c(g.size()), d(g.size());
     for (int it = 0; it < opt.max_iters; ++it) {
+        if (opt.cancel && opt.cancel->load(std::memory_order_relaxed)) return {w, f, it, false};
         centered_grad(w, g, c);            // c = g - (w·g)1
         d = w.array() * c.array();         // d_i = w_i * c_i
 
         // Check first-order stationarity: projected grad Π_w g -> small
         const double pg_norm = (c.array().square() * w.array()).sqrt().matrix().norm(); // ||W^(1/2) c||
         if (pg_norm < opt.tol * std::max(1.0, g.norm())) {
-            return {w, f, it, true};
+            const Stop st = at_stop();
+            if (st != Stop::Reseeded) return {w, f, it, st == Stop::Certified};
+            continue;
         }
 
         // Step-size cap
         double eta_cap = eta_max_cap(w, c);
         if (!std::isfinite(eta_cap)) {
-            // All c_i <= 0 ⇒ already optimal
-            return {w, f, it, true};
+            // All c_i <= 0 on the support ⇒ optimal there
+            const Stop st = at_stop();
+            if (st != Stop::Reseeded) return {w, f, it, st == Stop::Certified};
+            continue;
         }
         eta_cap = std::max(0.0, eta_cap - opt.eta_shrink);
 
@@ -103,14 +138,20 @@ CSResult minimize_cauchy_simplex(KObjective& obj,
             f_new = obj.value(w_new);
         }
 
-        // Convergence check
-        if ((w_new - w).norm() < opt.tol * std::max(1.0, w.norm()) &&
-            std::abs(f_new - f)   < opt.tol * std::max(1.0, std::abs(f))) {
-            return {w_new, f_new, it+1, true};
-        }
+        // Convergence check: the step stalled (also when Armijo backtracked to nothing)
+        const bool stalled = (w_new - w).norm() < opt.tol * std::max(1.0, w.norm()) &&
+                             std::abs(f_new - f) < opt.tol * std::max(1.0, std::abs(f));
 
         w.swap(w_new);
         f = obj.value_grad(w, g);
+        if (stalled) {
+            const Stop st = at_stop();
+            if (st != Stop::Reseeded) return {w, f, it+1, st == Stop::Certified};
+        }
     }
     return {w, f, opt.max_iters, false};
-}
\ No newline at end of file
+}
+
+#define ELLPH_INSTANTIATE_CAUCHY(D) \
+    template CSResult minimize_cauchy_simplex(KObjectiveT<D>&, const Eigen::VectorXd&, const CSOptions&);
+ELLPH_FOR_EACH_DIM(ELLPH_INSTANTIATE_CAUCHY)
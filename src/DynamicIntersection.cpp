@@ -0,0 +1,124 @@
+#include "DynamicIntersection.hpp"
+#include "LPSeidel.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+LPEval empty_eval() {
+    LPEval ev;
+    ev.eps_star = 0.0;
+    return ev;
+}
+}
+
+DynamicIntersection::DynamicIntersection(int d) : DynamicIntersection(d, Options{}) {}
+
+DynamicIntersection::DynamicIntersection(int d, Options opt)
+: opt_(opt), set_(d), ev_(empty_eval()), rng_(opt.seed), diff_(d) {
+    // Both precompute over every slot when an oracle is bound, i.e. on each re-solve
+    if (opt_.lp.spatial_index || opt_.lp.float_scan)
+        throw std::invalid_argument("DynamicIntersection: LPParams::spatial_index and float_scan are not supported");
+}
+
+DynamicIntersection::Id DynamicIntersection::insert(const Ellipsoid& E) {
+    if (E.dim() != d()) throw std::invalid_argument("DynamicIntersection::insert: dimension mismatch");
+    return insert(E.center(), E.precision(), E.radius());
+}
+
+DynamicIntersection::Id DynamicIntersection::insert(const Eigen::Ref<const Eigen::VectorXd>& center,
+                                                    const Eigen::Ref<const Eigen::MatrixXd>& precision,
+                                                    double radius) {
+    const int slot = take_slot(center, precision, radius);
+    const Id id = next_id_++;
+    slot_id_[slot] = id;
+    slot_of_.emplace(id, slot);
+    live_pos_[slot] = static_cast<int>(live_.size());
+    live_.push_back(slot);
+    ++stats_.inserts;
+
+    // The newcomer either lies within eps* of m, and the optimum is unchanged, or it
+    // belongs to the new basis
+    ++stats_.violation_tests;
+    if (violates(slot)) {
+        std::vector<int> front{slot};
+        front.insert(front.end(), basis_.begin(), basis_.end());
+        resolve(std::move(front));
+    }
+    return id;
+}
+
+bool DynamicIntersection::erase(Id id) {
+    const auto it = slot_of_.find(id);
+    if (it == slot_of_.end()) return false;
+    const int slot = it->second;
+    slot_of_.erase(it);
+
+    const int pos = live_pos_[slot];
+    live_[pos] = live_.back();
+    live_pos_[live_[pos]] = pos;
+    live_.pop_back();
+    slot_id_[slot] = -1;
+    free_.push_back(slot);
+    ++stats_.erases;
+
+    // Removing a non-basis element leaves the optimum as it is
+    const auto b = std::find(basis_.begin(), basis_.end(), slot);
+    if (b == basis_.end()) return true;
+    basis_.erase(b);
+    if (live_.empty()) {
+        ev_ = empty_eval();
+    } else {
+        resolve(basis_);
+    }
+    return true;
+}
+
+std::vector<DynamicIntersection::Id> DynamicIntersection::basis() const {
+    std::vector<Id> ids;
+    ids.reserve(basis_.size());
+    for (int s : basis_) ids.push_back(slot_id_[s]);
+    return ids;
+}
+
+int DynamicIntersection::take_slot(const Eigen::Ref<const Eigen::VectorXd>& center,
+                                   const Eigen::Ref<const Eigen::MatrixXd>& precision, double radius) {
+    if (!free_.empty()) {
+        const int slot = free_.back();
+        set_.assign(slot, center, precision, radius); // throws before anything changes
+        free_.pop_back();
+        return slot;
+    }
+    set_.push_back(center, precision, radius);
+    slot_id_.push_back(-1);
+    live_pos_.push_back(-1);
+    return set_.size() - 1;
+}
+
+bool DynamicIntersection::violates(int slot) const {
+    if (basis_.empty()) return true;
+    const double r = ev_.eps_star + opt_.lp.tight_tol;
+    return mahalanobis2_lower(set_.precision_factor(slot), set_.center(slot), ev_.m, diff_) > r * r;
+}
+
+void DynamicIntersection::resolve(std::vector<int> front) {
+    ++stats_.resolves;
+    // front first (the surviving basis, which mostly stays), the rest in a fresh random order
+    std::vector<int> order = std::move(front);
+    const size_t nfront = order.size();
+    order.reserve(live_.size());
+    for (int s : live_) {
+        if (std::find(order.begin(), order.begin() + nfront, s) == order.begin() + nfront)
+            order.push_back(s);
+    }
+    std::shuffle(order.begin() + nfront, order.end(), rng_);
+
+    // The arena moves when it grows, so each re-solve binds a fresh oracle to it (O(1)
+    // with the options the constructor allows)
+    const EllipsoidLPOracle O(set_, opt_.lp);
+    SeidelOptions so;
+    so.shuffle = false;
+    SeidelResult r = seidel_incremental(O, order, so);
+    stats_.violation_tests += r.violation_tests;
+    basis_ = std::move(r.basis.idx);
+    ev_ = std::move(r.eval);
+}
@@ -2,7 +2,8 @@
 #include <stdexcept>
 
 Ellipsoid::Ellipsoid(Vec center, std::optional<Mat> cov, std::optional<Mat> prec, double radius)
-    : center_(std::move(center)), cov_(std::move(cov)), prec_(std::move(prec)), radius_(radius)
+    : center_(std::move(center)), cov_(std::move(cov)), prec_(std::move(prec)), radius_(radius),
+      derived_(std::make_shared<Derived>())
 {
     if (!cov_ && !prec_) {
         throw std::invalid_argument("Ellipsoid: need covariance or precision.");
@@ -15,28 +16,47 @@ Ellipsoid::Ellipsoid(Vec center, std::optional<Mat> cov, std::optional<Mat> prec
     }
 }
 
+// inv(M) = L^{-T} L^{-1} for M = L L^T, via one triangular solve against I
+static Ellipsoid::Mat inverse_from_factor(const Ellipsoid::Mat& L) {
+    const Ellipsoid::Mat Linv = L.triangularView<Eigen::Lower>()
+                                    .solve(Ellipsoid::Mat::Identity(L.rows(), L.cols()));
+    return Linv.transpose() * Linv;
+}
+
 const Ellipsoid::Mat& Ellipsoid::covariance() const {
     if (cov_) return *cov_;
-    // Compute Σ = (A^{-1})^{-1} by robust Cholesky
-    Eigen::LLT<Mat> llt(*prec_);
-    if (llt.info() != Eigen::Success) {
-        throw std::runtime_error("Ellipsoid: precision not SPD (LLT failed).");
-    }
-    // Invert via Cholesky: inv(A) = L^{-T} L^{-1}
-    Mat L = llt.matrixL();
-    Mat Linv = L.inverse();   // For d<=~100 this is fine; for larger d prefer triangular solves on demand
-    cov_.emplace(Linv.transpose() * Linv);
-    return *cov_;
+    // Σ = (A^{-1})^{-1} from the cached factor of the precision
+    std::call_once(derived_->cov_once, [this]() {
+        derived_->cov = inverse_from_factor(precision_factor());
+    });
+    return derived_->cov;
 }
 
 const Ellipsoid::Mat& Ellipsoid::precision() const {
     if (prec_) return *prec_;
-    Eigen::LLT<Mat> llt(*cov_);
-    if (llt.info() != Eigen::Success) {
-        throw std::runtime_error("Ellipsoid: covariance not SPD (LLT failed).");
-    }
-    Mat L = llt.matrixL();
-    Mat Linv = L.inverse();
-    prec_.emplace(Linv.transpose() * Linv);
-    return *prec_;
-}
\ No newline at end of file
+    std::call_once(derived_->prec_once, [this]() {
+        Eigen::LLT<Mat> llt(*cov_);
+        if (llt.info() != Eigen::Success) {
+            throw std::runtime_error("Ellipsoid: covariance not SPD (LLT failed).");
+        }
+        derived_->prec = inverse_from_factor(llt.matrixL());
+    });
+    return derived_->prec;
+}
+
+const Ellipsoid::Mat& Ellipsoid::precision_factor() const {
+    std::call_once(derived_->factor_once, [this]() {
+        Eigen::LLT<Mat> llt(precision());
+        if (llt.info() != Eigen::Success) {
+            throw std::runtime_error("Ellipsoid: precision not SPD (LLT failed).");
+        }
+        derived_->L = llt.matrixL();
+    });
+    return derived_->L;
+}
+
+double Ellipsoid::mahalanobis2(const Eigen::Ref<const Vec>& x) const {
+    const Vec diff = x - center_;
+    const Vec t = precision_factor().transpose().triangularView<Eigen::Upper>() * diff;
+    return t.squaredNorm();
+}
@@ -0,0 +1,201 @@
+#include "EllipsoidDataset.hpp"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::uint64_t round_up(std::uint64_t x, std::uint64_t a) { return (x + a - 1) / a * a; }
+
+std::uint64_t block_doubles(int d, std::uint32_t layout) {
+    const std::uint64_t dd = static_cast<std::uint64_t>(d);
+    return (layout & kLayoutPacked) ? dd * (dd + 1) / 2 : dd * dd;
+}
+
+// Offset of column c in a packed lower triangle
+inline size_t packed_col(int d, int c) { return static_cast<size_t>(c) * d - static_cast<size_t>(c) * (c - 1) / 2; }
+
+} // namespace
+
+void check_dataset_header(const EllipsoidDatasetHeader& h, std::uint64_t file_bytes,
+                          const std::string& path) {
+    auto fail = [&](const std::string& why) {
+        throw std::runtime_error("ellipsoid dataset: " + why + " in " + path);
+    };
+    if (std::memcmp(h.magic, kEllipsoidFileMagic, sizeof h.magic) != 0) fail("bad magic");
+    if (h.version != 2) fail("unsupported version " + std::to_string(h.version));
+    if (h.d == 0 || h.n == 0 || h.n > static_cast<std::uint64_t>(INT32_MAX)) fail("bad n/d");
+
+    const std::uint64_t n = h.n;
+    const int d = static_cast<int>(h.d);
+    if (h.center_stride < static_cast<std::uint64_t>(d) ||
+        h.block_stride < block_doubles(d, h.layout)) fail("bad strides");
+    if ((h.centers_offset | h.blocks_offset | h.radii_offset) % 64 != 0) fail("misaligned section");
+    if (h.centers_offset + n * h.center_stride * sizeof(double) > file_bytes ||
+        h.blocks_offset + n * h.block_stride * sizeof(double) > file_bytes ||
+        h.radii_offset + n * sizeof(double) > file_bytes) fail("truncated sections");
+}
+
+void write_ellipsoid_dataset(const std::string& path, const std::vector<Ellipsoid>& Es,
+                             std::uint32_t layout) {
+    if (Es.empty()) throw std::invalid_argument("write_ellipsoid_dataset: empty ellipsoid set");
+    const int d = Es[0].dim();
+    const std::uint64_t n = Es.size();
+
+    EllipsoidDatasetHeader h{};
+    std::memcpy(h.magic, kEllipsoidFileMagic, sizeof h.magic);
+    h.version = 2;
+    h.d = static_cast<std::uint32_t>(d);
+    h.n = n;
+    h.layout = layout;
+    h.center_stride = round_up(d, 8);
+    h.block_stride = round_up(block_doubles(d, layout), 8);
+    h.centers_offset = round_up(sizeof h, 64);
+    h.blocks_offset = round_up(h.centers_offset + n * h.center_stride * sizeof(double), 64);
+    h.radii_offset = round_up(h.blocks_offset + n * h.block_stride * sizeof(double), 64);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("write_ellipsoid_dataset: cannot open " + path);
+    auto pad_to = [&](std::uint64_t off) {
+        static const char zeros[64] = {};
+        const auto pos = static_cast<std::uint64_t>(out.tellp());
+        out.write(zeros, static_cast<std::streamsize>(off - pos));
+    };
+    auto put = [&](const double* p, size_t count) {
+        out.write(reinterpret_cast<const char*>(p), static_cast<std::streamsize>(count * sizeof(double)));
+    };
+
+    out.write(reinterpret_cast<const char*>(&h), sizeof h);
+
+    pad_to(h.centers_offset);
+    std::vector<double> buf(std::max(h.center_stride, h.block_stride), 0.0);
+    for (const auto& E : Es) {
+        if (E.dim() != d) throw std::invalid_argument("write_ellipsoid_dataset: dimension mismatch");
+        std::fill(buf.begin(), buf.end(), 0.0);
+        Eigen::Map<Eigen::VectorXd>(buf.data(), d) = E.center();
+        put(buf.data(), h.center_stride);
+    }
+
+    pad_to(h.blocks_offset);
+    for (const auto& E : Es) {
+        std::fill(buf.begin(), buf.end(), 0.0);
+        const Eigen::MatrixXd& M = (layout & kLayoutFactor) ? E.precision_factor() : E.precision();
+        if (layout & kLayoutPacked) {
+            for (int c = 0; c < d; ++c)
+                Eigen::Map<Eigen::VectorXd>(buf.data() + packed_col(d, c), d - c) = M.col(c).tail(d - c);
+        } else if (layout & kLayoutFactor) {
+            Eigen::Map<Eigen::MatrixXd>(buf.data(), d, d) = M.triangularView<Eigen::Lower>();
+        } else {
+            Eigen::Map<Eigen::MatrixXd>(buf.data(), d, d) = M;
+        }
+        put(buf.data(), h.block_stride);
+    }
+
+    pad_to(h.radii_offset);
+    for (const auto& E : Es) {
+        const double r = E.radius();
+        put(&r, 1);
+    }
+    if (!out) throw std::runtime_error("write_ellipsoid_dataset: write failed for " + path);
+}
+
+Eigen::Map<const Eigen::MatrixXd> EllipsoidView::block() const {
+    if (layout_ & kLayoutPacked) throw std::logic_error("EllipsoidView::block: packed layout");
+    return {block_, d_, d_};
+}
+
+void EllipsoidView::precision_factor(Eigen::Ref<Eigen::MatrixXd> L) const {
+    if (L.rows() != d_ || L.cols() != d_) throw std::invalid_argument("precision_factor: wrong shape");
+    if (layout_ & kLayoutFactor) {
+        if (layout_ & kLayoutPacked) {
+            L.setZero();
+            for (int c = 0; c < d_; ++c)
+                L.col(c).tail(d_ - c) = Eigen::Map<const Eigen::VectorXd>(block_ + packed_col(d_, c), d_ - c);
+        } else {
+            L = block();
+        }
+        return;
+    }
+    Eigen::MatrixXd P(d_, d_);
+    precision(P);
+    Eigen::LLT<Eigen::MatrixXd> llt(P);
+    if (llt.info() != Eigen::Success) throw std::runtime_error("EllipsoidView: precision not SPD (LLT failed).");
+    L = llt.matrixL();
+}
+
+void EllipsoidView::precision(Eigen::Ref<Eigen::MatrixXd> P) const {
+    if (P.rows() != d_ || P.cols() != d_) throw std::invalid_argument("precision: wrong shape");
+    if (layout_ & kLayoutFactor) {
+        Eigen::MatrixXd L(d_, d_);
+        precision_factor(L);
+        P.noalias() = L * L.transpose();
+        return;
+    }
+    if (layout_ & kLayoutPacked) {
+        for (int c = 0; c < d_; ++c) {
+            P.col(c).tail(d_ - c) = Eigen::Map<const Eigen::VectorXd>(block_ + packed_col(d_, c), d_ - c);
+            P.row(c).tail(d_ - c) = P.col(c).tail(d_ - c).transpose();
+        }
+    } else {
+        P = block();
+    }
+}
+
+Ellipsoid EllipsoidView::to_ellipsoid() const {
+    Eigen::MatrixXd P(d_, d_);
+    precision(P);
+    return Ellipsoid(center(), std::nullopt, std::move(P), radius_);
+}
+
+EllipsoidDataset::EllipsoidDataset(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("EllipsoidDataset: cannot open " + path);
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) { ::close(fd); throw std::runtime_error("EllipsoidDataset: cannot stat " + path); }
+    bytes_ = static_cast<size_t>(st.st_size);
+    if (bytes_ < sizeof(EllipsoidDatasetHeader)) {
+        ::close(fd);
+        throw std::runtime_error("EllipsoidDataset: truncated header in " + path);
+    }
+    base_ = ::mmap(nullptr, bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps the file referenced
+    if (base_ == MAP_FAILED) { base_ = nullptr; throw std::runtime_error("EllipsoidDataset: mmap failed for " + path); }
+
+    const auto* bytes = static_cast<const char*>(base_);
+    hdr_ = reinterpret_cast<const EllipsoidDatasetHeader*>(bytes);
+    try {
+        check_dataset_header(*hdr_, bytes_, path);
+    } catch (...) {
+        ::munmap(base_, bytes_);
+        base_ = nullptr;
+        throw;
+    }
+
+    centers_ = reinterpret_cast<const double*>(bytes + hdr_->centers_offset);
+    blocks_  = reinterpret_cast<const double*>(bytes + hdr_->blocks_offset);
+    radii_   = reinterpret_cast<const double*>(bytes + hdr_->radii_offset);
+}
+
+EllipsoidDataset::~EllipsoidDataset() {
+    if (base_) ::munmap(base_, bytes_);
+}
+
+EllipsoidDataset::EllipsoidDataset(EllipsoidDataset&& o) noexcept
+: base_(std::exchange(o.base_, nullptr)), bytes_(o.bytes_), hdr_(o.hdr_),
+  centers_(o.centers_), blocks_(o.blocks_), radii_(o.radii_) {}
+
+EllipsoidDataset& EllipsoidDataset::operator=(EllipsoidDataset&& o) noexcept {
+    if (this != &o) {
+        if (base_) ::munmap(base_, bytes_);
+        base_ = std::exchange(o.base_, nullptr);
+        bytes_ = o.bytes_; hdr_ = o.hdr_;
+        centers_ = o.centers_; blocks_ = o.blocks_; radii_ = o.radii_;
+    }
+    return *this;
+}
@@ -0,0 +1,13 @@
+#include "EllipsoidIO.hpp"
+
+void write_ellipsoids(const std::string& path, const std::vector<Ellipsoid>& Es) {
+    write_ellipsoid_dataset(path, Es);
+}
+
+std::vector<Ellipsoid> read_ellipsoids(const std::string& path) {
+    const EllipsoidDataset ds(path);
+    std::vector<Ellipsoid> out;
+    out.reserve(ds.n());
+    for (int i = 0; i < ds.n(); ++i) out.push_back(ds[i].to_ellipsoid());
+    return out;
+}
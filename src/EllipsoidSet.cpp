@@ -0,0 +1,139 @@
+#include "EllipsoidSet.hpp"
+#include "EllipsoidDataset.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+namespace {
+constexpr size_t kAlign = 64;
+constexpr size_t pad8(size_t x) { return (x + 7) / 8 * 8; } // doubles -> whole 64-byte lines
+}
+
+void EllipsoidSet::Free::operator()(double* p) const noexcept { std::free(p); }
+
+EllipsoidSet::EllipsoidSet(int d, int capacity)
+: d_(d), vs_(pad8(static_cast<size_t>(d))), ms_(pad8(static_cast<size_t>(d) * d)) {
+    if (d <= 0) throw std::invalid_argument("EllipsoidSet: dimension must be positive");
+    reserve(capacity);
+}
+
+EllipsoidSet::EllipsoidSet(const std::vector<Ellipsoid>& Es)
+: EllipsoidSet(Es.empty() ? 1 : Es[0].dim(), static_cast<int>(Es.size())) {
+    if (Es.empty()) throw std::invalid_argument("EllipsoidSet: empty ellipsoid set");
+    for (const auto& E : Es) push_back(E);
+}
+
+EllipsoidSet::EllipsoidSet(const EllipsoidDataset& ds)
+: EllipsoidSet(ds.d(), ds.n()) {
+    Mat P(d_, d_);
+    for (int i = 0; i < ds.n(); ++i) {
+        const EllipsoidView v = ds[i];
+        v.precision(P);
+        push_back(v.center(), P, v.radius());
+    }
+}
+
+EllipsoidSet::EllipsoidSet(const EllipsoidSet& o)
+: d_(o.d_), vs_(o.vs_), ms_(o.ms_), scalars_(o.scalars_) {
+    if (o.n_ == 0) return;
+    regrow(o.n_);
+    n_ = o.n_;
+    for (int f = 0; f < kNumFields; ++f) {
+        const size_t stride = (f == kCenter || f == kAx) ? vs_ : ms_;
+        std::memcpy(base(Field(f)), o.base(Field(f)), sizeof(double) * stride * n_);
+    }
+}
+
+EllipsoidSet& EllipsoidSet::operator=(const EllipsoidSet& o) {
+    if (this != &o) *this = EllipsoidSet(o);
+    return *this;
+}
+
+size_t EllipsoidSet::field_offset(Field f, int cap) const noexcept {
+    // [centers | Ax | precisions | factors], cap slots each
+    const size_t c = static_cast<size_t>(cap);
+    switch (f) {
+        case kCenter:    return 0;
+        case kAx:        return c * vs_;
+        case kPrecision: return 2 * c * vs_;
+        case kFactor:    return 2 * c * vs_ + c * ms_;
+        default:         return 2 * c * vs_ + 2 * c * ms_;
+    }
+}
+
+void EllipsoidSet::regrow(int capacity) {
+    if (capacity <= cap_) return;
+    const size_t doubles = field_offset(kNumFields, capacity);
+    const size_t bytes = (doubles * sizeof(double) + kAlign - 1) / kAlign * kAlign;
+    std::unique_ptr<double[], Free> fresh(static_cast<double*>(std::aligned_alloc(kAlign, bytes)));
+    if (!fresh) throw std::bad_alloc();
+
+    // Move the used part of every field to its place in the larger arena
+    if (arena_) {
+        for (int f = 0; f < kNumFields; ++f) {
+            const size_t stride = (f == kCenter || f == kAx) ? vs_ : ms_;
+            std::memcpy(fresh.get() + field_offset(Field(f), capacity),
+                        arena_.get() + field_offset(Field(f), cap_),
+                        sizeof(double) * stride * n_);
+        }
+    }
+    arena_ = std::move(fresh);
+    cap_ = capacity;
+    scalars_.reserve(2 * static_cast<size_t>(capacity));
+}
+
+void EllipsoidSet::reserve(int capacity) {
+    if (d_ <= 0) throw std::logic_error("EllipsoidSet::reserve: dimension not set");
+    regrow(capacity);
+}
+
+double EllipsoidSet::fill(int i, const Eigen::Ref<const Vec>& center, const Eigen::Ref<const Mat>& precision) {
+    if (center.size() != d_ || precision.rows() != d_ || precision.cols() != d_)
+        throw std::invalid_argument("EllipsoidSet: dimension mismatch");
+    Eigen::Map<Vec> x(slot(kCenter, i), d_);
+    Eigen::Map<Vec> Ax(slot(kAx, i), d_);
+    Eigen::Map<Mat> P(slot(kPrecision, i), d_, d_);
+    Eigen::Map<Mat> L(slot(kFactor, i), d_, d_);
+
+    x = center;
+    P = precision;
+    Eigen::LLT<Eigen::Ref<Mat>> llt(L = P); // factor in place in the arena
+    if (llt.info() != Eigen::Success)
+        throw std::invalid_argument("EllipsoidSet: precision not SPD");
+    L.triangularView<Eigen::StrictlyUpper>().setZero();
+    Ax.noalias() = P * x;
+    return x.dot(Ax);
+}
+
+void EllipsoidSet::push_back(const Eigen::Ref<const Vec>& center, const Eigen::Ref<const Mat>& precision,
+                             double radius) {
+    if (n_ == cap_) regrow(std::max(16, 2 * cap_));
+    scalars_.push_back(fill(n_, center, precision));
+    scalars_.push_back(radius);
+    ++n_;
+}
+
+void EllipsoidSet::resize(int n) {
+    if (n < n_) throw std::invalid_argument("EllipsoidSet::resize: cannot shrink");
+    reserve(n);
+    scalars_.resize(2 * static_cast<size_t>(n));
+    n_ = n;
+}
+
+void EllipsoidSet::assign(int i, const Eigen::Ref<const Vec>& center, const Eigen::Ref<const Mat>& precision,
+                          double radius) {
+    if (i < 0 || i >= n_) throw std::out_of_range("EllipsoidSet::assign: index out of range");
+    scalars_[2 * static_cast<size_t>(i)] = fill(i, center, precision);
+    scalars_[2 * static_cast<size_t>(i) + 1] = radius;
+}
+
+void EllipsoidSet::push_back(const Ellipsoid& E) {
+    if (E.dim() != d_) throw std::invalid_argument("EllipsoidSet::push_back: dimension mismatch");
+    push_back(E.center(), E.precision(), E.radius());
+}
+
+Ellipsoid EllipsoidSet::to_ellipsoid(int i) const {
+    return Ellipsoid(center(i), std::nullopt, Mat(precision(i)), radius(i));
+}
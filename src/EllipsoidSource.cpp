@@ -0,0 +1,123 @@
+#include "EllipsoidSource.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+MemoryEllipsoidSource::MemoryEllipsoidSource(const std::vector<Ellipsoid>& all, int chunk_size)
+: all_(all), d_(all.empty() ? 0 : all[0].dim()), chunk_size_(chunk_size) {
+    if (all_.empty()) throw std::invalid_argument("MemoryEllipsoidSource: empty ellipsoid set");
+    if (chunk_size_ <= 0) throw std::invalid_argument("MemoryEllipsoidSource: chunk_size must be positive");
+    buf_.centers.resize(d_, chunk_size_);
+    buf_.factors.resize(d_, static_cast<Eigen::Index>(d_) * chunk_size_);
+}
+
+bool MemoryEllipsoidSource::next(const EllipsoidChunk*& out) {
+    const long long n = size();
+    if (pos_ >= n) return false;
+    buf_.first = pos_;
+    buf_.count = static_cast<int>(std::min<long long>(chunk_size_, n - pos_));
+    for (int j = 0; j < buf_.count; ++j) {
+        const Ellipsoid& E = all_[static_cast<size_t>(pos_ + j)];
+        buf_.centers.col(j) = E.center();
+        buf_.factors.middleCols(static_cast<Eigen::Index>(j) * d_, d_) = E.precision_factor();
+    }
+    pos_ += buf_.count;
+    out = &buf_;
+    return true;
+}
+
+namespace {
+
+// count doubles at byte offset off of in; false when the file ends first
+bool read_doubles(std::ifstream& in, std::uint64_t off, double* out, size_t count) {
+    in.clear();
+    in.seekg(static_cast<std::streamoff>(off));
+    in.read(reinterpret_cast<char*>(out), static_cast<std::streamsize>(count * sizeof(double)));
+    return static_cast<bool>(in);
+}
+
+} // namespace
+
+FileEllipsoidSource::FileEllipsoidSource(const std::string& path, int chunk_size)
+: path_(path), scan_(path, std::ios::binary), random_(path, std::ios::binary), chunk_size_(chunk_size) {
+    if (!scan_ || !random_) throw std::runtime_error("FileEllipsoidSource: cannot open " + path);
+    if (chunk_size_ <= 0) throw std::invalid_argument("FileEllipsoidSource: chunk_size must be positive");
+    scan_.read(reinterpret_cast<char*>(&hdr_), sizeof hdr_);
+    if (!scan_) throw std::runtime_error("FileEllipsoidSource: truncated header in " + path);
+    scan_.seekg(0, std::ios::end);
+    check_dataset_header(hdr_, static_cast<std::uint64_t>(scan_.tellg()), path);
+
+    const int d = this->d();
+    for (int b = 0; b < 2; ++b) {
+        buf_[b].centers.resize(d, chunk_size_);
+        buf_[b].factors.resize(d, static_cast<Eigen::Index>(d) * chunk_size_);
+        staging_[b].resize((hdr_.center_stride + hdr_.block_stride) * chunk_size_);
+    }
+}
+
+FileEllipsoidSource::~FileEllipsoidSource() {
+    if (pending_.valid()) pending_.wait();
+}
+
+void FileEllipsoidSource::drain() {
+    if (pending_.valid()) pending_.wait();
+    pending_ = {};
+}
+
+void FileEllipsoidSource::read_chunk(int b, long long first) {
+    const int d = this->d();
+    const size_t cs = hdr_.center_stride, bs = hdr_.block_stride;
+    EllipsoidChunk& c = buf_[b];
+    c.first = first;
+    c.count = static_cast<int>(std::min<long long>(chunk_size_, size() - first));
+
+    double* centers = staging_[b].data();
+    double* blocks = centers + cs * chunk_size_;
+    const std::uint64_t f = static_cast<std::uint64_t>(first);
+    if (!read_doubles(scan_, hdr_.centers_offset + f * cs * sizeof(double), centers, cs * c.count) ||
+        !read_doubles(scan_, hdr_.blocks_offset + f * bs * sizeof(double), blocks, bs * c.count))
+        throw std::runtime_error("FileEllipsoidSource: truncated file " + path_);
+
+    for (int j = 0; j < c.count; ++j) {
+        const EllipsoidView v(centers + cs * j, blocks + bs * j, 0.0, d, hdr_.layout);
+        c.centers.col(j) = v.center();
+        v.precision_factor(c.factors.middleCols(static_cast<Eigen::Index>(j) * d, d));
+    }
+}
+
+void FileEllipsoidSource::start_read(int b, long long first) {
+    reading_ = b;
+    pending_ = std::async(std::launch::async, [this, b, first]() { read_chunk(b, first); });
+}
+
+void FileEllipsoidSource::begin_pass() {
+    drain();
+    start_read(0, 0);
+}
+
+bool FileEllipsoidSource::next(const EllipsoidChunk*& out) {
+    if (!pending_.valid()) return false; // pass finished (or never started)
+    pending_.get();                      // rethrows read errors
+    const int b = reading_;
+    const EllipsoidChunk& c = buf_[b];
+
+    // Overlap: read the following chunk into the other buffer while the caller works on this one
+    const long long after = c.first + c.count;
+    if (after < size()) start_read(1 - b, after);
+
+    out = &c;
+    return true;
+}
+
+Ellipsoid FileEllipsoidSource::fetch(long long i) {
+    if (i < 0 || i >= size()) throw std::out_of_range("FileEllipsoidSource::fetch: index out of range");
+    const std::uint64_t u = static_cast<std::uint64_t>(i);
+    const int d = this->d();
+    std::vector<double> center(d), block(hdr_.block_stride);
+    double radius = 0.0;
+    if (!read_doubles(random_, hdr_.centers_offset + u * hdr_.center_stride * sizeof(double), center.data(), d) ||
+        !read_doubles(random_, hdr_.blocks_offset + u * hdr_.block_stride * sizeof(double), block.data(), block.size()) ||
+        !read_doubles(random_, hdr_.radii_offset + u * sizeof(double), &radius, 1))
+        throw std::runtime_error("FileEllipsoidSource: truncated file " + path_);
+    return EllipsoidView(center.data(), block.data(), radius, d, hdr_.layout).to_ellipsoid();
+}
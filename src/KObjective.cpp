@@ -1,98 +1,277 @@
 #include "KObjective.hpp"
+#include "EllipsoidSet.hpp"
+#include "PerfCounters.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <stdexcept>
 
-KObjective::KObjective(double epsilon,
-                       const std::vector<Vec>& centers,
-                       const std::vector<Mat>& precisions)
-: eps_(epsilon), dim_(0), centers_(centers), Ainv_(precisions)
+template <int D>
+void KObjectiveT<D>::Workspace::reserve(int dim, int k) {
+    if (dim != d) {
+        d = dim;
+        S.resize(d, d);
+        mu.resize(d); m.resize(d); Sm.resize(d); w.resize(d); diff.resize(d); t.resize(d);
+        G.resize(d, d); eig = Eigen::SelfAdjointEigenSolver<MatD>(d); gamma.resize(d); delta.resize(d);
+        cap = local_cap = 0;
+    }
+    if (k <= cap) return;
+    cap = std::max(k, 2 * cap);
+    d2.resize(cap);
+    R.resize(d, cap);
+    Y.resize(d, cap);
+}
+
+template <int D>
+void KObjectiveT<D>::Workspace::reserve_local(int k) {
+    if (k <= local_cap) return;
+    local_cap = std::max(k, 2 * local_cap);
+    X.resize(d, local_cap);
+    AX.resize(d, local_cap);
+    P.resize(d, static_cast<Eigen::Index>(d) * local_cap);
+    L.resize(d, static_cast<Eigen::Index>(d) * local_cap);
+    q.resize(local_cap);
+}
+
+template <int D>
+KObjectiveT<D>::KObjectiveT(double epsilon,
+                            const std::vector<Vec>& centers,
+                            const std::vector<Mat>& precisions)
+: eps_(epsilon)
+{
+    init(centers, precisions, nullptr);
+}
+
+template <int D>
+KObjectiveT<D>::KObjectiveT(double epsilon,
+                            const std::vector<Vec>& centers,
+                            const std::vector<Mat>& precisions,
+                            const std::vector<Mat>& factors)
+: eps_(epsilon)
+{
+    init(centers, precisions, &factors);
+}
+
+template <int D>
+KObjectiveT<D>::KObjectiveT(double epsilon, const KSource& src, std::span<const int> subset,
+                            Workspace* ws)
+: eps_(epsilon)
 {
-    const int k = static_cast<int>(centers_.size());
-    if (k == 0 || centers_.size() != Ainv_.size())
+    bind(src, subset, ws);
+}
+
+template <int D>
+KObjectiveT<D>::KObjectiveT(double epsilon, const EllipsoidSet& set, std::span<const int> subset,
+                            Workspace* ws)
+: eps_(epsilon)
+{
+    KSource src;
+    src.n = set.size();
+    src.d = set.d();
+    src.centers = set.centers_data();              src.center_stride = set.vec_stride();
+    src.factors = set.factors_data();              src.factor_stride = set.mat_stride();
+    src.precisions = set.precisions_data();        src.precision_stride = set.mat_stride();
+    src.Ax = set.precision_centers_data();         src.Ax_stride = set.vec_stride();
+    src.q = set.q_data();                          src.q_stride = EllipsoidSet::q_stride();
+    bind(src, subset, ws);
+}
+
+template <int D>
+KObjectiveT<D>::KObjectiveT(const KObjectiveT& other, Workspace* ws)
+: eps_(other.eps_), dim_(other.dim_), k_(other.k_), subset_(other.subset_),
+  X_(other.X_), Ainv_(other.Ainv_), L_(other.L_), Ax_(other.Ax_), q_(other.q_)
+{
+    use_workspace(ws);
+}
+
+template <int D>
+void KObjectiveT<D>::use_workspace(Workspace* ws) {
+    if (!ws) {
+        own_ = std::make_unique<Workspace>();
+        ws = own_.get();
+    }
+    ws_ = ws;
+    ws_->reserve(dim_, k_);
+    ws_->d2.head(k_).setZero();
+}
+
+template <int D>
+void KObjectiveT<D>::init(const std::vector<Vec>& centers,
+                          const std::vector<Mat>& precisions,
+                          const std::vector<Mat>* factors) {
+    const int k = static_cast<int>(centers.size());
+    if (k == 0 || centers.size() != precisions.size() ||
+        (factors && factors->size() != centers.size()))
         throw std::invalid_argument("centers and precisions must be nonempty and same length.");
 
-    dim_ = static_cast<int>(centers_[0].size());
+    // Validate before copying: fixed-size targets cannot absorb a size mismatch
+    dim_ = static_cast<int>(centers[0].size());
+    if (D != Eigen::Dynamic && dim_ != D)
+        throw std::invalid_argument("dimension does not match the fixed-size objective.");
     for (int i = 0; i < k; ++i) {
-        if (centers_[i].size() != dim_ || Ainv_[i].rows() != dim_ || Ainv_[i].cols() != dim_)
+        if (centers[i].size() != dim_ || precisions[i].rows() != dim_ || precisions[i].cols() != dim_ ||
+            (factors && ((*factors)[i].rows() != dim_ || (*factors)[i].cols() != dim_)))
             throw std::invalid_argument("dimension mismatch in centers/precisions.");
     }
 
-    q_.resize(k);
+    // Copy into an owned workspace and read it like any other source
+    k_ = k;
+    use_workspace(nullptr);
+    Workspace& ws = *ws_;
+    ws.reserve_local(k);
+    const Eigen::Index dd = dim_;
     for (int i = 0; i < k; ++i) {
-        q_[i] = centers_[i].transpose() * (Ainv_[i] * centers_[i]);
+        ws.X.col(i) = centers[i];
+        ws.P.middleCols(i * dd, dd) = precisions[i];
+        if (factors) {
+            ws.L.middleCols(i * dd, dd) = (*factors)[i];
+        } else {
+            Eigen::LLT<MatD> llt(precisions[i]);
+            if (llt.info() != Eigen::Success)
+                throw std::invalid_argument("precision matrices must be SPD.");
+            ws.L.middleCols(i * dd, dd) = llt.matrixL();
+        }
+        ws.AX.col(i).noalias() = precisions[i] * centers[i];
+        ws.q[i] = centers[i].dot(ws.AX.col(i));
     }
+    const size_t dsz = static_cast<size_t>(dim_);
+    X_    = {ws.X.data(),  dsz,       true};
+    Ainv_ = {ws.P.data(),  dsz * dsz, true};
+    L_    = {ws.L.data(),  dsz * dsz, true};
+    Ax_   = {ws.AX.data(), dsz,       true};
+    q_    = {ws.q.data(),  1,         true};
+}
+
+template <int D>
+void KObjectiveT<D>::bind(const KSource& src, std::span<const int> subset, Workspace* ws) {
+    k_ = subset.empty() ? src.n : static_cast<int>(subset.size());
+    dim_ = src.d;
+    if (k_ == 0) throw std::invalid_argument("centers and precisions must be nonempty and same length.");
+    if (!src.centers || (!src.factors && !src.precisions))
+        throw std::invalid_argument("KObjective: source needs centers and factors or precisions");
+    if (D != Eigen::Dynamic && dim_ != D)
+        throw std::invalid_argument("dimension does not match the fixed-size objective.");
+    for (int i : subset)
+        if (i < 0 || i >= src.n) throw std::out_of_range("KObjective: subset index out of range");
+
+    subset_ = subset;
+    use_workspace(ws);
+    X_    = {src.centers,    src.center_stride,    false};
+    Ainv_ = {src.precisions, src.precision_stride, false};
+    L_    = {src.factors,    src.factor_stride,    false};
+    Ax_   = {src.Ax,         src.Ax_stride,        false};
+    q_    = {src.q,          src.q_stride,         false};
+    if (src.precisions && src.factors && src.Ax && src.q) return;
 
-    S_.resize(dim_, dim_);
-    mu_.resize(dim_);
-    m_.resize(dim_);
-    Sm_.resize(dim_);
-    d2_.setZero(k);
+    // Derive what the source lacks for the k selected indices, into the workspace
+    Workspace& w = *ws_;
+    w.reserve_local(k_);
+    const Eigen::Index dd = dim_;
+    const size_t dsz = static_cast<size_t>(dim_);
+    for (int j = 0; j < k_; ++j) {
+        auto P = w.P.middleCols(j * dd, dd);
+        auto L = w.L.middleCols(j * dd, dd);
+        if (!src.precisions) P.noalias() = factor(j) * factor(j).transpose();
+        if (!src.factors) {
+            L = precision(j);
+            Eigen::LLT<Eigen::Ref<Mat>> llt(L); // in place
+            if (llt.info() != Eigen::Success)
+                throw std::invalid_argument("precision matrices must be SPD.");
+            L.template triangularView<Eigen::StrictlyUpper>().setZero();
+        }
+    }
+    if (!src.precisions) Ainv_ = {w.P.data(), dsz * dsz, true};
+    if (!src.factors)    L_    = {w.L.data(), dsz * dsz, true};
+    if (!src.Ax || !src.q) {
+        for (int j = 0; j < k_; ++j) {
+            w.AX.col(j).noalias() = precision(j) * center(j);
+            w.q[j] = center(j).dot(w.AX.col(j));
+        }
+        Ax_ = {w.AX.data(), dsz, true};
+        q_  = {w.q.data(),  1,   true};
+    }
 }
 
-void KObjective::assemble_S_mu(const Vec& lambda) {
-    const int k = static_cast<int>(centers_.size());
-    S_.setZero();
-    mu_.setZero();
-    for (int i = 0; i < k; ++i) {
-        const double w = lambda[i];
-        if (w == 0.0) continue;
-        S_.noalias() += w * Ainv_[i];
-        mu_.noalias() += w * (Ainv_[i] * centers_[i]);
+template <int D>
+void KObjectiveT<D>::assemble_S_mu(const Eigen::Ref<const Vec>& lambda) {
+    Workspace& w = *ws_;
+    w.S.setZero();
+    w.mu.setZero();
+    for (int i = 0; i < k_; ++i) {
+        const double li = lambda[i];
+        if (li == 0.0) continue;
+        w.S.noalias() += li * precision(i);
+        w.mu.noalias() += li * precision_center(i);
     }
-    lltS_.compute(S_);
-    if (lltS_.info() != Eigen::Success) {
+    w.llt.compute(w.S);
+    ELLPH_PERF_ADD(llt_factorizations, 1);
+    if (w.llt.info() != Eigen::Success) {
+        ELLPH_PERF_ADD(llt_failures, 1);
         throw std::runtime_error("LLT failed: S(λ) must be SPD.");
     }
-    // Sm_ = S*m = mu_; but m unknown yet
-    Sm_ = mu_;
+    // Sm = S*m = mu; but m unknown yet
+    w.Sm = w.mu;
+    R_valid_ = false;
 }
 
-void KObjective::solve_centroid() {
+template <int D>
+void KObjectiveT<D>::solve_centroid() {
     // Solve S m = mu via LLT
-    m_ = lltS_.solve(mu_);
-    if (lltS_.info() != Eigen::Success) {
+    Workspace& w = *ws_;
+    w.m = w.mu;
+    w.llt.solveInPlace(w.m);
+    if (w.llt.info() != Eigen::Success) {
         throw std::runtime_error("LLT solve failed for centroid.");
     }
 }
 
-double KObjective::C_value() const {
+template <int D>
+double KObjectiveT<D>::C_value() const {
     // C(λ) = sum λ q_i - m^T S m ; but S m = mu => m^T S m = m^T mu
     // We don't have λ here; caller should accumulate sum λ q_i externally if needed.
     // Provide only the second term contribution:
     return 0.0; // not used directly in this form
 }
 
-void KObjective::distances_squared() {
-    const int k = static_cast<int>(centers_.size());
-    for (int j = 0; j < k; ++j) {
-        const Vec diff = m_ - centers_[j];
-        d2_[j] = diff.transpose() * (Ainv_[j] * diff);
+template <int D>
+void KObjectiveT<D>::distances_squared() {
+    Workspace& w = *ws_;
+    for (int j = 0; j < k_; ++j) {
+        w.diff.noalias() = w.m - center(j);
+        // d_j^2 = ||L_j^T (m - x_j)||^2
+        w.t.noalias() = factor(j).transpose().template triangularView<Eigen::Upper>() * w.diff;
+        w.d2[j] = w.t.squaredNorm();
     }
 }
 
-double KObjective::value(const Eigen::Ref<const Vec>& lambda) {
+template <int D>
+double KObjectiveT<D>::value(const Eigen::Ref<const Vec>& lambda) {
+    ELLPH_PERF_ADD(objective_evals, 1);
     assemble_S_mu(lambda);
     solve_centroid();
     double sum_lq = 0.0;
-    for (int i = 0; i < lambda.size(); ++i) sum_lq += lambda[i] * q_[i];
-    const double mSm = m_.dot(Sm_); // == m^T mu
+    for (int i = 0; i < lambda.size(); ++i) sum_lq += lambda[i] * q(i);
+    const double mSm = ws_->m.dot(ws_->Sm); // == m^T mu
     const double C = sum_lq - mSm;
     return eps_*eps_ - C;
 }
 
-double KObjective::value_grad(const Eigen::Ref<const Vec>& lambda,
-                              Eigen::Ref<Vec> grad) {
+template <int D>
+double KObjectiveT<D>::value_grad(const Eigen::Ref<const Vec>& lambda,
+                                  Eigen::Ref<Vec> grad) {
     const double val = value(lambda);
     distances_squared();
     // NO RESIZE on Ref:
     if (grad.size() != lambda.size())
         throw std::invalid_argument("value_grad: grad has wrong size");
-    for (int j = 0; j < grad.size(); ++j) grad[j] = -d2_[j];
+    for (int j = 0; j < grad.size(); ++j) grad[j] = -ws_->d2[j];
     return val;
 }
 
-double KObjective::value_grad_hess(const Eigen::Ref<const Vec>& lambda,
-                                   Eigen::Ref<Vec> grad,
-                                   Eigen::Ref<Mat> hess) {
+template <int D>
+double KObjectiveT<D>::value_grad_hess(const Eigen::Ref<const Vec>& lambda,
+                                       Eigen::Ref<Vec> grad,
+                                       Eigen::Ref<Mat> hess) {
     const int k = static_cast<int>(lambda.size());
     if (grad.size() != k)  throw std::invalid_argument("value_grad_hess: grad wrong size");
     if (hess.rows() != k || hess.cols() != k)
@@ -100,18 +279,110 @@ double KObjective::value_grad_hess(const Eigen::Ref<const Vec>& lambda,
 
     const double val = value_grad(lambda, grad); // will fill grad
 
-    // Build Hessian into provided matrix (no resize)
-    std::vector<Vec> y(k, Vec::Zero(d()));
-    for (int j = 0; j < k; ++j) {
-        const Vec rhs = Ainv_[j] * (m_ - centers_[j]);
-        y[j] = lltS_.solve(rhs);
-        if (lltS_.info() != Eigen::Success)
-            throw std::runtime_error("LLT solve failed in Hessian.");
+    // H = 2 R^T S^{-1} R: one multi-RHS solve and one GEMM into the caller's matrix
+    build_R();
+    const auto R = ws_->R.leftCols(k_);
+    auto Y = ws_->Y.leftCols(k_);
+    Y = R;
+    ws_->llt.solveInPlace(Y);
+    hess.noalias() = R.transpose() * Y;
+    hess *= 2.0;
+    return val;
+}
+
+template <int D>
+void KObjectiveT<D>::build_R() {
+    if (R_valid_) return;
+    Workspace& w = *ws_;
+    for (int j = 0; j < k_; ++j) {
+        // A_j^{-1}(m - x_j) = A_j^{-1} m - A_j^{-1} x_j
+        w.R.col(j).noalias() = precision(j) * w.m;
+        w.R.col(j) -= precision_center(j);
     }
-    for (int i = 0; i < k; ++i) {
-        const Vec left = Ainv_[i] * (m_ - centers_[i]);
-        for (int j = 0; j < k; ++j)
-            hess(i,j) = 2.0 * left.dot(y[j]);
+    R_valid_ = true;
+}
+
+template <int D>
+void KObjectiveT<D>::hess_vec(const Eigen::Ref<const Vec>& v, Eigen::Ref<Vec> out) {
+    if (v.size() != k() || out.size() != k())
+        throw std::invalid_argument("hess_vec: v/out wrong size");
+    build_R();
+    Workspace& w = *ws_;
+    const auto R = w.R.leftCols(k_);
+    w.w.noalias() = R * v;
+    w.llt.solveInPlace(w.w);
+    out.noalias() = R.transpose() * w.w;
+    out *= 2.0;
+}
+
+template <int D>
+int KObjectiveT<D>::solve_pair(Eigen::Ref<Vec> lambda) {
+    if (k_ != 2) throw std::invalid_argument("solve_pair: needs exactly two ellipsoids");
+    if (lambda.size() != 2) throw std::invalid_argument("solve_pair: lambda wrong size");
+    Workspace& w = *ws_;
+
+    // With A_1^{-1} = L_1 L_1^T and G G^T = Q diag(γ) Q^T for G = L_1^{-1} L_2, V = L_1^{-T} Q
+    // gives V^T A_1^{-1} V = I and V^T A_2^{-1} V = diag(γ). In those coordinates, with
+    // δ = V^{-1}(x_2 - x_1) = Q^T L_1^T (x_2 - x_1) and s_j = 1 - t + t γ_j,
+    //   m - x_1 = V (t γ ∘ δ / s),  d_1^2 = Σ (t γ_j δ_j / s_j)^2,
+    //   d_2^2 = Σ γ_j ((1 - t) δ_j / s_j)^2,  d/dt (d_1^2 - d_2^2) = 2 Σ γ_j^2 δ_j^2 / s_j^3
+    const auto L1 = factor(0).template triangularView<Eigen::Lower>();
+    w.G = factor(1).template triangularView<Eigen::Lower>();
+    L1.solveInPlace(w.G);
+    w.S.noalias() = w.G * w.G.transpose();
+    w.eig.compute(w.S);
+    if (w.eig.info() != Eigen::Success) throw std::runtime_error("solve_pair: eigensolver failed");
+    w.gamma = w.eig.eigenvalues().cwiseMax(0.0);
+    w.diff.noalias() = center(1) - center(0);
+    w.t.noalias() = L1.transpose() * w.diff;
+    w.delta.noalias() = w.eig.eigenvectors().transpose() * w.t;
+
+    // h(t) = d_1^2 - d_2^2 runs from -Σ γ δ^2 at t = 0 to Σ δ^2 at t = 1
+    auto h = [&](double t, double& dh) {
+        double f = 0.0;
+        dh = 0.0;
+        for (int j = 0; j < dim_; ++j) {
+            const double g = w.gamma[j], dl2 = w.delta[j] * w.delta[j];
+            const double s = 1.0 - t + t * g;
+            f += dl2 * g * (t * t * g - (1.0 - t) * (1.0 - t)) / (s * s);
+            dh += 2.0 * g * g * dl2 / (s * s * s);
+        }
+        return f;
+    };
+    double t = 0.5;
+    int iters = 0;
+    if (w.delta.squaredNorm() > 0.0) { // equal centers: m = x_1 for every λ
+        double lo = 0.0, hi = 1.0;
+        for (; iters < 100; ++iters) {
+            double dh;
+            const double f = h(t, dh);
+            if (f == 0.0) break;
+            (f < 0.0 ? lo : hi) = t;
+            const double step = f / dh;
+            if (std::abs(step) <= 4.0 * std::numeric_limits<double>::epsilon() * std::max(t, 1.0 - t)) {
+                ++iters;
+                break;
+            }
+            t -= step;
+            if (!(t > lo && t < hi)) t = 0.5 * (lo + hi); // Newton left the bracket
+            if (hi - lo <= 4.0 * std::numeric_limits<double>::epsilon()) {
+                ++iters;
+                break;
+            }
+        }
     }
-    return val;
-}
\ No newline at end of file
+
+    for (int j = 0; j < dim_; ++j)
+        w.w[j] = t * w.gamma[j] * w.delta[j] / (1.0 - t + t * w.gamma[j]);
+    w.t.noalias() = w.eig.eigenvectors() * w.w;
+    L1.transpose().solveInPlace(w.t);
+    w.m = center(0) + w.t;
+    distances_squared();
+    R_valid_ = false;
+    lambda[0] = 1.0 - t;
+    lambda[1] = t;
+    return iters;
+}
+
+#define ELLPH_INSTANTIATE_KOBJECTIVE(D) template class KObjectiveT<D>;
+ELLPH_FOR_EACH_DIM(ELLPH_INSTANTIATE_KOBJECTIVE)
@@ -1,73 +1,295 @@
 #include "LPClarkson.hpp"
+#include "ThreadPool.hpp"
 #include <random>
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
 #include <numeric>
+#include <stdexcept>
+
+namespace {
+
+struct Scan {
+    std::vector<int> violators; // positions into S, increasing
+    double Wviol = 0.0;
+    PerfCounters perf;          // of the worker that scanned this chunk
+};
+
+// Violator scan of S against B, optionally split into contiguous chunks over a pool.
+// Chunk lists are concatenated in order, so the list equals the serial one. Weights are
+// integer powers of two (1, doubled), so their sums are exact in any summation order.
+// indexed: S is 0..n-1 and O has a spatial index, so one violators_all query replaces
+// the scan (positions are indices).
+Scan scan_violators(const EllipsoidLPOracle& O, const std::vector<int>& S,
+                    const std::vector<double>& w, const LPBasis& B, const LPEval& evB,
+                    WorkStealingPool* pool, bool indexed)
+{
+    const int n = (int)S.size();
+    if (indexed) {
+        Scan out;
+        out.violators = O.violators_all(B, evB);
+        for (int t : out.violators) out.Wviol += w[t];
+        return out;
+    }
+    const int nchunks = pool ? std::min(n, 4 * pool->size()) : 1;
+    if (nchunks <= 1) {
+        Scan out;
+        out.violators = O.violators(B, evB, S);
+        for (int t : out.violators) out.Wviol += w[t];
+        return out;
+    }
+
+    std::vector<Scan> parts(nchunks);
+    pool->parallel_for(0, nchunks, [&](int c) {
+        const int lo = (int)((long long)n * c / nchunks);
+        const int hi = (int)((long long)n * (c + 1) / nchunks);
+        const perf::Scope scope;
+        Scan& p = parts[c];
+        p.violators = O.violators(B, evB, std::span<const int>(S.data() + lo, hi - lo));
+        for (int& t : p.violators) { t += lo; p.Wviol += w[t]; }
+        p.perf = scope.delta();
+    });
+
+    Scan out;
+    size_t total = 0;
+    for (const auto& p : parts) total += p.violators.size();
+    out.violators.reserve(total);
+    for (const auto& p : parts) {
+        out.violators.insert(out.violators.end(), p.violators.begin(), p.violators.end());
+        out.Wviol += p.Wviol;
+        perf::absorb(p.perf);
+    }
+    return out;
+}
+
+// opt.pool, else a pool of opt.threads workers held by own; null when serial
+WorkStealingPool* pool_for(const ClarksonOptions& opt, std::unique_ptr<WorkStealingPool>& own) {
+    if (opt.pool) return opt.pool;
+    if (opt.threads > 1) own = std::make_unique<WorkStealingPool>(WorkStealingPool::Options{opt.threads});
+    return own.get();
+}
+
+} // namespace
 
 ClarksonResult clarkson_iterative(const EllipsoidLPOracle& O,
                                   const std::vector<int>& S,
                                   ClarksonOptions opt)
 {
+    const perf::Scope scope;
     const int n = (int)S.size();
     const int d = O.d();
     const int ksam = (opt.sample_size > 0) ? opt.sample_size : 4*(d+1)*(d+1);
+    const int nsamples = std::max(1, opt.parallel_samples);
 
     std::vector<double> w(n, 1.0);
+    double Wall = n; // sum of w, updated on each doubling
     std::mt19937_64 rng(opt.seed);
 
+    bool indexed = O.has_spatial_index() && n == O.n();
+    for (int t = 0; t < n && indexed; ++t) indexed = S[t] == t;
+
+    std::unique_ptr<WorkStealingPool> own;
+    WorkStealingPool* const pool = pool_for(opt, own);
+
     LPBasis B{{}, 0.0};
-    int vt = 0, doublings = 0;
+    long long vt = 0;
+    int doublings = 0;
 
     for (int round = 0; round < opt.rounds; ++round) {
-        // sample ksam indices with probability proportional to weight
+        // sample ksam indices with probability proportional to weight,
+        // nsamples times (drawn serially so the RNG stream is thread-independent)
         std::discrete_distribution<int> pick(w.begin(), w.end());
-        std::vector<int> R; R.reserve(ksam);
-        for (int t = 0; t < ksam && n>0; ++t) R.push_back(S[pick(rng)]);
+        std::vector<std::vector<int>> Cs(nsamples);
+        for (auto& C : Cs) {
+            std::vector<int> R; R.reserve(ksam);
+            for (int t = 0; t < ksam && n>0; ++t) R.push_back(S[pick(rng)]);
 
-        // Build candidate set C = R ∪ B
-        std::vector<int> C = R;
-        C.insert(C.end(), B.idx.begin(), B.idx.end());
-        std::sort(C.begin(), C.end());
-        C.erase(std::unique(C.begin(), C.end()), C.end());
+            // Build candidate set C = R ∪ B
+            C = R;
+            C.insert(C.end(), B.idx.begin(), B.idx.end());
+            std::sort(C.begin(), C.end());
+            C.erase(std::unique(C.begin(), C.end()), C.end());
+        }
 
-        // // Compute basis of C
-        // B = O.compute_basis(C);
-
-        // // Scan violators in S; also accumulate their total weight
-        // double Wviol = 0.0, Wall = 0.0;
-        // std::vector<int> violators;
-        // violators.reserve(n);
-        // for (int t = 0; t < n; ++t) {
-        //     ++vt;
-        //     if (O.is_violator(B, S[t])) {
-        //         violators.push_back(t);
-        //         Wviol += w[t];
-        //     }
-        //     Wall += w[t];
-        // }
-        // Compute basis of C
-        B = O.compute_basis(C);
-
-        // Evaluate once on B
-        LPEval evB = O.evaluate(B.idx);
-
-        // Scan violators using cached evB
-        double Wviol = 0.0, Wall = 0.0;
-        std::vector<int> violators; violators.reserve(n);
-        for (int t = 0; t < n; ++t) {
-            ++vt;
-            const bool v = O.is_violator(B, S[t], evB);
-            if (v) { violators.push_back(t); Wviol += w[t]; }
-            Wall += w[t];
+        // Compute basis of each C (concurrently when there is more than one),
+        // warm-started from λ* on the current basis B ⊆ C (a cache hit)
+        const LPEval evPrev = O.evaluate(B.idx);
+        std::vector<LPBasis> Bs(nsamples);
+        if (pool && nsamples > 1) {
+            std::vector<PerfCounters> perfs(nsamples);
+            pool->parallel_for(0, nsamples, [&](int s) {
+                const perf::Scope sc;
+                Bs[s] = O.compute_basis(Cs[s], &B, &evPrev);
+                perfs[s] = sc.delta();
+            });
+            for (const auto& pc : perfs) perf::absorb(pc);
+        } else {
+            for (int s = 0; s < nsamples; ++s) Bs[s] = O.compute_basis(Cs[s], &B, &evPrev);
         }
 
-        if (Wviol / std::max(Wall, 1e-300) > opt.weight_bad_threshold) {
-            for (int id : violators) w[id] *= 2.0; // double weights of bad guys
+        // Take the first sample whose violators carry little weight; if none does,
+        // double the violators of the first one (exactly the serial rule for nsamples == 1)
+        Scan first;
+        bool accepted = false, done = false;
+        for (int s = 0; s < nsamples && !accepted; ++s) {
+            // Evaluate once on the candidate basis and scan S with the batched kernel
+            LPEval evB = O.evaluate(Bs[s].idx);
+            Scan sc = scan_violators(O, S, w, Bs[s], evB, pool, indexed);
+            vt += n;
+
+            if (sc.Wviol / std::max(Wall, 1e-300) <= opt.weight_bad_threshold) {
+                B = Bs[s];
+                accepted = true;
+                // Success if no violators (or negligible)
+                done = sc.violators.empty();
+            } else if (s == 0) {
+                first = std::move(sc);
+            }
+        }
+
+        if (!accepted) {
+            B = Bs[0];
+            for (int id : first.violators) w[id] *= 2.0; // double weights of bad guys
+            Wall += first.Wviol;
             ++doublings;
             continue; // next round
         }
+        if (done) break;
+    }
+    return {B, vt, doublings, scope.delta()};
+}
 
-        // Success if no violators (or negligible)
-        if (violators.empty()) break;
+ClarksonResult clarkson_streaming(EllipsoidSource& src, const LPParams& params,
+                                  ClarksonOptions opt)
+{
+    const long long n = src.size();
+    const int d = src.d();
+    if (n <= 0) throw std::invalid_argument("clarkson_streaming: empty source");
+    if (n > std::numeric_limits<int>::max())
+        throw std::invalid_argument("clarkson_streaming: more ellipsoids than int indices");
+    const int ksam = (opt.sample_size > 0) ? opt.sample_size : 4*(d+1)*(d+1);
+    const perf::Scope scope;
+
+    // Weight of i is 2^(e[i] & kExp); kViol marks a violator of this round's basis
+    constexpr std::uint8_t kViol = 0x80, kExp = 0x7f;
+    std::vector<std::uint8_t> e(static_cast<size_t>(n), 0);
+    std::mt19937_64 rng(opt.seed);
+
+    std::unique_ptr<WorkStealingPool> own;
+    WorkStealingPool* const pool = pool_for(opt, own);
+
+    std::vector<int> B;         // basis, global indices (sorted)
+    std::vector<Ellipsoid> BE;  // its ellipsoids, aligned with B
+    double epsB = 0.0;
+    long long vt = 0;
+    int doublings = 0;
+
+    for (int round = 0; round < opt.rounds; ++round) {
+        double Wall = 0.0;
+        for (std::uint8_t x : e) Wall += std::ldexp(1.0, x & kExp);
+
+        // Weighted sample without materializing per-element weights: sorted uniform
+        // targets in [0, Wall) against one running prefix sum
+        std::vector<double> targets(ksam);
+        std::uniform_real_distribution<double> U(0.0, Wall);
+        for (double& t : targets) t = U(rng);
+        std::sort(targets.begin(), targets.end());
+        std::vector<int> C;
+        C.reserve(ksam + B.size());
+        {
+            double prefix = 0.0;
+            size_t t = 0;
+            for (long long i = 0; i < n && t < targets.size(); ++i) {
+                prefix += std::ldexp(1.0, e[i] & kExp);
+                while (t < targets.size() && targets[t] < prefix) { C.push_back((int)i); ++t; }
+            }
+            for (; t < targets.size(); ++t) C.push_back((int)(n - 1)); // rounding at the top end
+        }
+        C.insert(C.end(), B.begin(), B.end());
+        std::sort(C.begin(), C.end());
+        C.erase(std::unique(C.begin(), C.end()), C.end());
+
+        // Oracle over the sample only; local index t <-> global C[t]
+        std::vector<Ellipsoid> CE;
+        CE.reserve(C.size());
+        for (int id : C) {
+            auto it = std::lower_bound(B.begin(), B.end(), id);
+            CE.push_back(it != B.end() && *it == id ? BE[it - B.begin()] : src.fetch(id));
+        }
+        LPParams lp = params;
+        lp.cache_capacity = std::min<size_t>(lp.cache_capacity, 256);
+        EllipsoidLPOracle O(CE, d, lp);
+
+        std::vector<int> Cloc(C.size());
+        std::iota(Cloc.begin(), Cloc.end(), 0);
+        LPBasis Bloc{{}, epsB};
+        for (int id : B) Bloc.idx.push_back(int(std::lower_bound(C.begin(), C.end(), id) - C.begin()));
+        LPBasis nb;
+        if (Bloc.idx.empty()) {
+            nb = O.compute_basis(Cloc);
+        } else {
+            const LPEval evPrev = O.evaluate(Bloc.idx); // warm start from λ* on the old basis
+            nb = O.compute_basis(Cloc, &Bloc, &evPrev);
+        }
+        const LPEval evB = O.evaluate(nb.idx);
+
+        // Sequential violator pass over the source
+        const double r = evB.eps_star + params.tight_tol;
+        const double r2 = r * r;
+        double Wviol = 0.0;
+        long long nviol = 0;
+        {
+            ELLPH_PERF_PHASE(timer, PerfPhase::Scan); // the pass, as seen by this thread
+            src.begin_pass();
+            const EllipsoidChunk* ch = nullptr;
+            while (src.next(ch)) {
+                auto scan = [&](int lo, int hi, double& W, long long& cnt) {
+                    Eigen::VectorXd diff(d);
+                    for (int j = lo; j < hi; ++j) {
+                        const double d2 = mahalanobis2_lower(
+                            ch->factors.middleCols(static_cast<Eigen::Index>(j) * d, d),
+                            ch->centers.col(j), evB.m, diff);
+                        if (d2 > r2) {
+                            std::uint8_t& x = e[static_cast<size_t>(ch->first + j)];
+                            W += std::ldexp(1.0, x & kExp);
+                            x |= kViol;
+                            ++cnt;
+                        }
+                    }
+                };
+                const int parts = pool ? std::min(ch->count, 4 * pool->size()) : 1;
+                if (parts <= 1) {
+                    scan(0, ch->count, Wviol, nviol);
+                } else {
+                    std::vector<double> Wp(parts, 0.0);
+                    std::vector<long long> np(parts, 0);
+                    pool->parallel_for(0, parts, [&](int p) {
+                        scan((int)((long long)ch->count * p / parts),
+                             (int)((long long)ch->count * (p + 1) / parts), Wp[p], np[p]);
+                    });
+                    for (int p = 0; p < parts; ++p) { Wviol += Wp[p]; nviol += np[p]; }
+                }
+            }
+        }
+        vt += n;
+
+        // Adopt the new basis either way (as in clarkson_iterative); double on a bad round
+        B.clear(); BE.clear();
+        std::vector<int> order = nb.idx;
+        std::sort(order.begin(), order.end());
+        for (int t : order) { B.push_back(C[t]); BE.push_back(CE[t]); }
+        epsB = nb.eps_star;
+
+        const bool accepted = Wviol / std::max(Wall, 1e-300) <= opt.weight_bad_threshold;
+        for (std::uint8_t& x : e) {
+            if (!(x & kViol)) continue;
+            x &= kExp;
+            if (!accepted && x < kExp) ++x;
+        }
+        if (!accepted) { ++doublings; continue; }
+        if (nviol == 0) break;
     }
-    return {B, vt, doublings};
-}
\ No newline at end of file
+    return {LPBasis{B, epsB}, vt, doublings, scope.delta()};
+}
@@ -25,34 +25,6 @@
 //     LPBasis Bnew = O.compute_basis(C);
 //     return seidel_inner(O, perm, upto-1, Bnew, depth-1, vt_count);
 // }
-static SeidelResult seidel_inner(const EllipsoidLPOracle& O,
-                                 const std::vector<int>& perm,
-                                 int upto,
-                                 LPBasis B,
-                                 int depth,
-                                 int& vt_count)
-{
-    if (upto < 0 || depth <= 0) return {B, vt_count};
-
-    // Recurse on prefix
-    SeidelResult r = seidel_inner(O, perm, upto-1, B, depth, vt_count);
-
-    // Evaluate **once** on the current basis
-    LPEval evB = O.evaluate(r.basis.idx);
-
-    // Check violator with cached evB
-    int x = perm[upto];
-    ++vt_count;
-    if (!O.is_violator(r.basis, x, evB)) return r;
-
-    // Violation: grow basis and recompute
-    std::vector<int> C = r.basis.idx; C.push_back(x);
-    LPBasis Bnew = O.compute_basis(C);
-
-    // Tail recurse with the **new** basis
-    return seidel_inner(O, perm, upto-1, Bnew, depth-1, vt_count);
-}
-
 // SeidelResult seidel_incremental(const EllipsoidLPOracle& O,
 //                                 const std::vector<int>& S,
 //                                 SeidelOptions opt)
@@ -67,18 +39,94 @@ static SeidelResult seidel_inner(const EllipsoidLPOracle& O,
 //     out.violation_tests = vt;
 //     return out;
 // }
+namespace {
+// One level of the recursion: the basis of order[0, end), starting from B ⊆ order[0, end)
+// and testing positions next.. in turn. A violator h at position p opens a frame on
+// [0, p+1) (h included) from basis(B ∪ {h}), whose result replaces B.
+struct Frame {
+    int next;     // position of the next element to test
+    int end;
+    LPBasis B;
+    LPEval ev;    // evaluation of B, refreshed only when B changes
+};
+}
+
 SeidelResult seidel_incremental(const EllipsoidLPOracle& O,
                                 const std::vector<int>& S,
                                 SeidelOptions opt)
 {
-    std::vector<int> perm = S;
-    std::mt19937_64 rng(opt.seed);
-    std::shuffle(perm.begin(), perm.end(), rng);
+    const perf::Scope scope;
+    std::vector<int> order = S;
+    if (opt.shuffle) {
+        std::mt19937_64 rng(opt.seed);
+        std::shuffle(order.begin(), order.end(), rng);
+    }
+
+    // Position of each index in order, for move-to-front
+    std::vector<int> where;
+    if (opt.move_to_front) {
+        where.assign(O.n(), -1);
+        for (int p = 0; p < (int)order.size(); ++p) where[order[p]] = p;
+    }
+
+    SeidelResult out;
+    std::vector<Frame> stack;
+    stack.reserve(O.d() + 2);
+    stack.push_back(Frame{0, (int)order.size(), LPBasis{{}, 0.0}, O.evaluate({})});
+
+    while (true) {
+        Frame& F = stack.back();
+        const int hit = O.first_violator(F.B, F.ev,
+                                         std::span<const int>(order.data() + F.next, F.end - F.next));
+        out.violation_tests += (hit < 0 ? F.end - F.next : hit + 1);
+
+        if (hit >= 0) {
+            F.next += hit;
+            const int h = order[F.next];
+            std::vector<int> C = F.B.idx; C.push_back(h);
+            LPBasis Bn = O.compute_basis(C, &F.B, &F.ev);
+            // h violates B, so it belongs to the new basis; the tight-set reduction can
+            // lose it to rounding, in which case keep all of B ∪ {h}
+            if (std::find(Bn.idx.begin(), Bn.idx.end(), h) == Bn.idx.end()) Bn.idx = std::move(C);
+            LPEval ev = O.evaluate(Bn.idx, &F.B, &F.ev);
+            Bn.eps_star = ev.eps_star;
 
-    int vt = 0;
-    LPBasis B0{{}, 0.0};
-    const int depth0 = (opt.max_depth < 0 ? O.d() + 1 : opt.max_depth);
-    auto out = seidel_inner(O, perm, (int)perm.size()-1, B0, depth0, vt);
-    out.violation_tests = vt;
+            if (opt.max_depth >= 0 && (int)stack.size() > opt.max_depth) {
+                // At the cap: take the new basis without re-checking [0, next) (not exact)
+                F.B = std::move(Bn);
+                F.ev = std::move(ev);
+                ++F.next;
+                continue;
+            }
+
+            const int end = F.next + 1; // F is invalidated by the push
+            int next = 0;
+            if (opt.move_to_front) {
+                // Basis first: its elements never violate it, so the scan skips them
+                for (int j : Bn.idx) {
+                    const int p = where[j], q = next++;
+                    std::swap(order[p], order[q]);
+                    where[order[p]] = p;
+                    where[order[q]] = q;
+                }
+            }
+            stack.push_back(Frame{next, end, std::move(Bn), std::move(ev)});
+            out.depth = std::max(out.depth, (int)stack.size() - 1);
+            continue;
+        }
+
+        // Frame done: B is the basis of [0, end); hand it to the parent
+        if (stack.size() == 1) break;
+        Frame done = std::move(stack.back());
+        stack.pop_back();
+        Frame& P = stack.back();
+        P.B = std::move(done.B);
+        P.ev = std::move(done.ev);
+        P.next = done.end;
+    }
+
+    out.basis = std::move(stack.back().B);
+    out.eval = std::move(stack.back().ev);
+    out.perf = scope.delta();
     return out;
-}
\ No newline at end of file
+}
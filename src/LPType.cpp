@@ -1,43 +1,154 @@
 // LPType.cpp
 #include "LPType.hpp"
+#include "PerfCounters.hpp"
 #include <algorithm>
 #include <stdexcept>
 #include <limits>
 #include <cmath>
 #include <numeric>
+#include <string>
+#include <unordered_map>
 
-EllipsoidLPOracle::EllipsoidLPOracle(const std::vector<Ellipsoid>& all, int ambient_dim, LPParams p)
-: all_(all), d_(ambient_dim), P_(p) {
-    if (all_.empty()) throw std::invalid_argument("Oracle: empty ellipsoid set");
+// λ*_j above this marks j as part of the support in compute_basis
+static constexpr double kSupportTol = 1e-6;
+
+EllipsoidLPOracle::EllipsoidLPOracle(std::span<const Ellipsoid> all, int ambient_dim, LPParams p)
+: all_(all.data()), n_(static_cast<int>(all.size())), d_(ambient_dim), P_(p),
+  cache_(OracleCache::Options{p.cache_capacity}) {
+    if (all.empty()) throw std::invalid_argument("Oracle: empty ellipsoid set");
+
+    // Pack centers and precision factors contiguously so violation scans stream through memory
+    centers_.resize(d_, n_);
+    factors_.resize(d_, static_cast<Eigen::Index>(d_) * n_);
+    for (int i = 0; i < n_; ++i) {
+        if (all[i].dim() != d_) throw std::invalid_argument("Oracle: dimension mismatch");
+        centers_.col(i) = all[i].center();
+        factors_.middleCols(static_cast<Eigen::Index>(i) * d_, d_) = all[i].precision_factor();
+    }
+    cptr_ = centers_.data(); cstride_ = d_;
+    fptr_ = factors_.data(); fstride_ = static_cast<size_t>(d_) * d_;
+    bind_source();
 }
 
-KObjective EllipsoidLPOracle::make_K_for_subset(const std::vector<int>& subset) const {
-    std::vector<Ellipsoid> Es; Es.reserve(subset.size());
-    for (int idx : subset) Es.push_back(all_[idx]);
-    return make_Kobjective_from_ellipsoids(/*epsilon*/1.0, Es);
+EllipsoidLPOracle::EllipsoidLPOracle(const EllipsoidDataset& ds, LPParams p)
+: ds_(&ds), n_(ds.n()), d_(ds.d()), P_(p), cache_(OracleCache::Options{p.cache_capacity}) {
+    cptr_ = ds.centers_data(); cstride_ = ds.center_stride();
+    if ((ds.layout() & kLayoutFactor) && !(ds.layout() & kLayoutPacked)) {
+        fptr_ = ds.blocks_data(); fstride_ = ds.block_stride();
+    } else {
+        factors_.resize(d_, static_cast<Eigen::Index>(d_) * n_);
+        for (int i = 0; i < n_; ++i)
+            ds[i].precision_factor(factors_.middleCols(static_cast<Eigen::Index>(i) * d_, d_));
+        fptr_ = factors_.data(); fstride_ = static_cast<size_t>(d_) * d_;
+    }
+    bind_source();
 }
 
+EllipsoidLPOracle::EllipsoidLPOracle(const EllipsoidSet& set, LPParams p)
+: set_(&set), n_(set.size()), d_(set.d()), P_(p), cache_(OracleCache::Options{p.cache_capacity}) {
+    if (set.empty()) throw std::invalid_argument("Oracle: empty ellipsoid set");
+    cptr_ = set.centers_data(); cstride_ = set.vec_stride();
+    fptr_ = set.factors_data(); fstride_ = set.mat_stride();
+    bind_source();
+}
 
-// uint64_t EllipsoidLPOracle::key_from_indices(const std::vector<int>& idx) {
-//     // order-insensitive hash: 64-bit mix of sorted indices
-//     uint64_t h = 1469598103934665603ULL;
-//     for (int v : idx) { h ^= (uint64_t)(v + 0x9e3779b97f4a7c15ULL); h *= 1099511628211ULL; }
-//     return h;
-// }
-static inline uint64_t fnv_mix(uint64_t h, uint64_t x){
-    h ^= x + 0x9e3779b97f4a7c15ULL;
-    h *= 1099511628211ULL;
-    return h;
+void EllipsoidLPOracle::bind_source() {
+    src_.n = n_;
+    src_.d = d_;
+    src_.centers = cptr_; src_.center_stride = cstride_;
+    src_.factors = fptr_; src_.factor_stride = fstride_;
+    if (set_) { // the arena also holds the precisions, A_i^{-1} x_i and q_i
+        src_.precisions = set_->precisions_data(); src_.precision_stride = set_->mat_stride();
+        src_.Ax = set_->precision_centers_data();  src_.Ax_stride = set_->vec_stride();
+        src_.q = set_->q_data();                   src_.q_stride = EllipsoidSet::q_stride();
+    }
+    if (P_.spatial_index) {
+        // Extreme eigenvalues of A_i^{-1} = L_i L_i^T: squared extreme singular values of L_i
+        // (fixed-size closed-form solver for d = 2, 3)
+        std::vector<double> lmin(n_), lmax(n_);
+        dispatch_dim(d_, [&](auto dim) {
+            constexpr int D = decltype(dim)::value;
+            using MatD = Eigen::Matrix<double, D, D>;
+            Eigen::SelfAdjointEigenSolver<MatD> eig(d_);
+            MatD L(d_, d_), A(d_, d_);
+            for (int i = 0; i < n_; ++i) {
+                L = factor_of(i).triangularView<Eigen::Lower>();
+                A.noalias() = L * L.transpose();
+                if constexpr (D == 2 || D == 3) eig.computeDirect(A, Eigen::EigenvaluesOnly);
+                else eig.compute(A, Eigen::EigenvaluesOnly);
+                lmin[i] = std::max(0.0, eig.eigenvalues()[0]);
+                lmax[i] = eig.eigenvalues()[d_ - 1];
+            }
+        });
+        index_ = std::make_unique<SpatialIndex>(cptr_, cstride_, n_, d_, std::move(lmin), std::move(lmax));
+    }
+    if (!P_.float_scan) return;
+
+    const size_t tri = static_cast<size_t>(d_) * (d_ + 1) / 2;
+    fcenters_.resize(static_cast<size_t>(n_) * d_);
+    ffactors_.resize(static_cast<size_t>(n_) * tri);
+    lnorm_.resize(n_);
+    cnorm_.resize(n_);
+    for (int i = 0; i < n_; ++i) {
+        const auto c = center_of(i);
+        const auto L = factor_of(i);
+        Eigen::Map<Eigen::VectorXf>(fcenters_.data() + static_cast<size_t>(i) * d_, d_) = c.cast<float>();
+        float* f = ffactors_.data() + static_cast<size_t>(i) * tri;
+        for (int k = 0; k < d_; ++k) {
+            Eigen::Map<Eigen::VectorXf>(f, d_ - k) = L.col(k).tail(d_ - k).cast<float>();
+            f += d_ - k;
+        }
+        lnorm_[i] = L.triangularView<Eigen::Lower>().toDenseMatrix().norm();
+        cnorm_[i] = c.norm();
+    }
 }
 
-uint64_t EllipsoidLPOracle::key_from_set(const std::vector<int>& idx) {
-    std::vector<int> s = idx;
-    std::sort(s.begin(), s.end());
-    uint64_t h = 1469598103934665603ULL;
-    for (int v : s) h = fnv_mix(h, (uint64_t)v);
-    return h;
+bool EllipsoidLPOracle::exceeds_mixed(int i, const Eigen::VectorXd& m, const Eigen::VectorXf& mf,
+                                      double mnorm, double r2, Eigen::VectorXd& diff,
+                                      Eigen::VectorXf& fdiff, long long& fallbacks) const {
+    // t = L_i^T (m - c_i) and d2 = ||t||^2, all in float
+    const size_t tri = static_cast<size_t>(d_) * (d_ + 1) / 2;
+    fdiff.noalias() = mf - Eigen::Map<const Eigen::VectorXf>(fcenters_.data() + static_cast<size_t>(i) * d_, d_);
+    const float* f = ffactors_.data() + static_cast<size_t>(i) * tri;
+    float d2f = 0.0f;
+    for (int k = 0; k < d_; ++k) {
+        const float t = Eigen::Map<const Eigen::VectorXf>(f, d_ - k).dot(fdiff.tail(d_ - k));
+        d2f += t * t;
+        f += d_ - k;
+    }
+
+    // Error of d2f against the exact d2, to first order in u = 2^-24 (float rounding):
+    //   ||Δt|| <= ||L||_F [ (u + γ) ||diff|| + u (||m|| + ||c|| + ||diff||) ]
+    // from rounding L, c, m and the difference to float and the length-d dot products
+    // (γ = γ_{d+2}), and |Δd2| <= γ d2 + (2 ||t|| + ||Δt||) ||Δt||; doubled for the
+    // second-order terms and the float evaluation itself
+    constexpr double u = 0x1.0p-24;
+    const double g = (d_ + 2) * u / (1.0 - (d_ + 2) * u);
+    const double dn = std::sqrt(static_cast<double>(fdiff.squaredNorm()));
+    const double Et = lnorm_[i] * ((u + g) * dn + u * (mnorm + cnorm_[i] + dn));
+    const double d2 = d2f;
+    const double bound = 2.0 * (g * d2 + (2.0 * std::sqrt(d2) + Et) * Et);
+
+    if (d2 - bound > r2) return true;
+    if (d2 + bound <= r2) return false;
+    ++fallbacks;
+    return mahalanobis2_packed(i, m, diff) > r2;
+}
+
+double EllipsoidLPOracle::mahalanobis2_packed(int i, const Eigen::VectorXd& m,
+                                              Eigen::VectorXd& diff) const {
+    return mahalanobis2_lower(factor_of(i), center_of(i), m, diff);
+}
+
+template <int D>
+KObjectiveT<D> EllipsoidLPOracle::make_K_for_subset(std::span<const int> subset) const {
+    // Refers to the kernel's data through subset; scratch comes from one workspace per
+    // thread, so once it has grown a new basis is evaluated without allocating
+    thread_local typename KObjectiveT<D>::Workspace ws;
+    return KObjectiveT<D>(/*epsilon*/1.0, src_, subset, &ws);
 }
 
+
 // Changing!
 // LPEval EllipsoidLPOracle::evaluate(const std::vector<int>& B) const {
 //     if (B.empty()) {
@@ -64,7 +175,32 @@ uint64_t EllipsoidLPOracle::key_from_set(const std::vector<int>& idx) {
 //     cache_.emplace(key, ev);
 //     return ev;
 // }
-LPEval EllipsoidLPOracle::evaluate(const std::vector<int>& B) const {
+
+// Second opinion for a solve P_.inner did not certify: Newton, or PGD when that was Newton
+static SolverKind fallback_solver(SolverKind inner) {
+    return inner == SolverKind::Newton || inner == SolverKind::Portfolio ? SolverKind::PGD : SolverKind::Newton;
+}
+
+// λ0 on the sorted set T from a solved set W (any order): λ_W where T meets W, 0 elsewhere.
+// Empty if W carries no mass on T (caller falls back to the uniform start).
+static Eigen::VectorXd warm_lambda(std::span<const int> T,
+                                   const std::vector<int>& W, const Eigen::VectorXd& lamW) {
+    if (lamW.size() != (Eigen::Index)W.size()) return Eigen::VectorXd();
+    Eigen::VectorXd lam0 = Eigen::VectorXd::Zero((Eigen::Index)T.size());
+    double mass = 0.0;
+    for (int j = 0; j < (int)W.size(); ++j) {
+        auto it = std::lower_bound(T.begin(), T.end(), W[j]);
+        if (it != T.end() && *it == W[j]) {
+            lam0[it - T.begin()] = lamW[j];
+            mass += lamW[j];
+        }
+    }
+    if (!(mass > 0.0)) return Eigen::VectorXd();
+    return lam0 / mass;
+}
+
+LPEval EllipsoidLPOracle::evaluate(const std::vector<int>& B,
+                                   const LPBasis* warm, const LPEval* evWarm) const {
     if (B.empty()) {
         LPEval z; z.eps_star = 0.0;
         z.m = Eigen::VectorXd::Zero(d_);
@@ -73,32 +209,57 @@ LPEval EllipsoidLPOracle::evaluate(const std::vector<int>& B) const {
         return z;
     }
 
-    const uint64_t key = key_from_set(B);
+    const IndexKey key(B);
     CacheVal cv;
-    auto it = cache_.find(key);
-    if (it == cache_.end()) {
-        // Solve on a canonical order (sorted), but cache only (eps, m)
-        std::vector<int> Bsorted = B;
-        std::sort(Bsorted.begin(), Bsorted.end());
-        auto K = make_K_for_subset(Bsorted);
-        auto res = optimal_radius(K, P_.inner);  // returns eps_star, dists (in that order), lambda_star
-        cv = CacheVal{res.eps_star, K.centroid()};
-        cache_.emplace(key, cv);
+    if (cache_.find(key, cv)) {
+        ELLPH_PERF_ADD(cache_hits, 1);
     } else {
-        cv = it->second;
+        ELLPH_PERF_ADD(cache_misses, 1);
+        ELLPH_PERF_PHASE(timer, PerfPhase::Solve);
+        // Solve on a canonical order (sorted); cache (eps, m, λ*) in that order
+        const auto sorted = key.indices();
+        Eigen::VectorXd lam0;
+        if (P_.warm_start && warm && evWarm) lam0 = warm_lambda(sorted, warm->idx, evWarm->lambda);
+        auto solve = [&](auto dim) {
+            auto K = make_K_for_subset<decltype(dim)::value>(sorted);
+            auto res = optimal_radius(K, P_.inner, lam0.size() ? &lam0 : nullptr);
+            inner_iters_.fetch_add(res.iters, std::memory_order_relaxed);
+            if (!res.converged || !gap_within(res)) {
+                // Not trusted (iteration cap, stalled steps): redo it cold with another
+                // solver and keep the better certificate; fail loudly when neither passes
+                fallback_solves_.fetch_add(1, std::memory_order_relaxed);
+                auto alt = optimal_radius(K, fallback_solver(P_.inner));
+                inner_iters_.fetch_add(alt.iters, std::memory_order_relaxed);
+                if (alt.gap <= res.gap) {
+                    res = std::move(alt);
+                } else {
+                    Eigen::VectorXd g(K.k()); // K back at the kept λ*, for its centroid
+                    K.value_grad(res.lambda_star, g);
+                }
+                if (!gap_within(res))
+                    throw std::runtime_error("EllipsoidLPOracle: inner solve on " + std::to_string(sorted.size()) +
+                                             " ellipsoids not certified (gap " + std::to_string(res.gap) + ")");
+            }
+            return CacheVal{res.eps_star, K.centroid(), res.lambda_star};
+        };
+        cv = P_.fixed_dim ? dispatch_dim(d_, solve) : solve(DimTag<Eigen::Dynamic>{});
+        inner_solves_.fetch_add(1, std::memory_order_relaxed);
+        // Solved outside any lock; a concurrent solve of the same set yields the same value
+        cache_.insert(key, cv);
     }
 
-    // Recompute per-constraint distances in the **caller’s order**
+    // Recompute per-constraint distances in the **caller’s order**, and permute λ* to it
+    const auto sorted = key.indices();
     Eigen::VectorXd d(B.size());
+    Eigen::VectorXd lam(B.size());
+    Eigen::VectorXd diff(d_);
     for (int t = 0; t < (int)B.size(); ++t) {
-        const Ellipsoid& Ei = all_[ B[t] ];
-        const Eigen::VectorXd diff = cv.m - Ei.center();
-        const double d2 = diff.transpose() * (Ei.precision() * diff);
+        const double d2 = mahalanobis2_packed(B[t], cv.m, diff);
         d[t] = std::sqrt(d2);  // distances (not squared), to match your convention
+        lam[t] = cv.lambda[std::lower_bound(sorted.begin(), sorted.end(), B[t]) - sorted.begin()];
     }
 
-    // λ* not needed by Seidel; leave empty unless you really need it
-    return LPEval{cv.eps_star, cv.m, d, Eigen::VectorXd()};
+    return LPEval{cv.eps_star, cv.m, d, lam};
 }
 
 
@@ -118,11 +279,93 @@ LPEval EllipsoidLPOracle::evaluate(const std::vector<int>& B) const {
 // }
 
 bool EllipsoidLPOracle::is_violator(const LPBasis& B, int i, const LPEval& evB) const {
-    if (B.idx.empty()) return true; // seed the first constraint
-    const Ellipsoid& Ei = all_[i];
-    const Eigen::VectorXd diff = evB.m - Ei.center();
-    const double di_sq = diff.transpose() * (Ei.precision() * diff);
-    return (std::sqrt(di_sq) > evB.eps_star + P_.tight_tol);
+    if (B.idx.empty()) return true; // seed: everything violates the empty basis
+    // One distance on the double path (the float scan decides the same way); the scratch
+    // is per thread, so a test allocates nothing once it is sized
+    thread_local Eigen::VectorXd diff;
+    diff.resize(d_);
+    const double r = evB.eps_star + P_.tight_tol;
+    return mahalanobis2_packed(i, evB.m, diff) > r * r;
+}
+
+std::vector<int> EllipsoidLPOracle::violators(const LPBasis& B, const LPEval& evB,
+                                              std::span<const int> candidates) const {
+    const int nc = static_cast<int>(candidates.size());
+    std::vector<int> out;
+    if (B.idx.empty()) { // seed: everything violates the empty basis
+        out.resize(nc);
+        std::iota(out.begin(), out.end(), 0);
+        return out;
+    }
+    ELLPH_PERF_PHASE(timer, PerfPhase::Scan);
+    // sqrt(d2) > r  <=>  d2 > r^2  (r >= 0)
+    const double r = evB.eps_star + P_.tight_tol;
+    const double r2 = r * r;
+    Eigen::VectorXd diff(d_);
+    if (P_.float_scan) {
+        const Eigen::VectorXf mf = evB.m.cast<float>();
+        const double mnorm = evB.m.norm();
+        Eigen::VectorXf fdiff(d_);
+        long long fallbacks = 0;
+        for (int t = 0; t < nc; ++t) {
+            if (exceeds_mixed(candidates[t], evB.m, mf, mnorm, r2, diff, fdiff, fallbacks)) out.push_back(t);
+        }
+        ELLPH_PERF_ADD(float_tests, nc);
+        ELLPH_PERF_ADD(float_fallbacks, fallbacks);
+        return out;
+    }
+    for (int t = 0; t < nc; ++t) {
+        if (mahalanobis2_packed(candidates[t], evB.m, diff) > r2) out.push_back(t);
+    }
+    return out;
+}
+
+int EllipsoidLPOracle::first_violator(const LPBasis& B, const LPEval& evB,
+                                      std::span<const int> candidates) const {
+    const int nc = static_cast<int>(candidates.size());
+    if (nc == 0) return -1;
+    if (B.idx.empty()) return 0;
+    ELLPH_PERF_PHASE(timer, PerfPhase::Scan);
+    const double r = evB.eps_star + P_.tight_tol;
+    const double r2 = r * r;
+    Eigen::VectorXd diff(d_);
+    if (P_.float_scan) {
+        const Eigen::VectorXf mf = evB.m.cast<float>();
+        const double mnorm = evB.m.norm();
+        Eigen::VectorXf fdiff(d_);
+        long long fallbacks = 0;
+        int t = 0;
+        for (; t < nc; ++t) {
+            if (exceeds_mixed(candidates[t], evB.m, mf, mnorm, r2, diff, fdiff, fallbacks)) break;
+        }
+        ELLPH_PERF_ADD(float_tests, std::min(t + 1, nc));
+        ELLPH_PERF_ADD(float_fallbacks, fallbacks);
+        return t < nc ? t : -1;
+    }
+    for (int t = 0; t < nc; ++t) {
+        if (mahalanobis2_packed(candidates[t], evB.m, diff) > r2) return t;
+    }
+    return -1;
+}
+
+std::vector<int> EllipsoidLPOracle::violators_all(const LPBasis& B, const LPEval& evB) const {
+    if (!index_ || B.idx.empty()) {
+        std::vector<int> all(n_);
+        std::iota(all.begin(), all.end(), 0);
+        return violators(B, evB, all);
+    }
+    ELLPH_PERF_PHASE(timer, PerfPhase::Scan);
+    const double r = evB.eps_star + P_.tight_tol;
+    const double r2 = r * r;
+    std::vector<int> out, ambiguous;
+    index_->query(evB.m, r2, out, ambiguous);
+    // The shell: exact tests, as violators() would run them
+    if (!ambiguous.empty()) {
+        std::sort(ambiguous.begin(), ambiguous.end()); // locality in the factor arrays
+        for (int t : violators(B, evB, ambiguous)) out.push_back(ambiguous[t]);
+    }
+    std::sort(out.begin(), out.end());
+    return out;
 }
 
 // Keep the old is_violator(B,i) as a slow fallback that just calls evaluate(B.idx) once:
@@ -180,11 +423,14 @@ std::vector<int> EllipsoidLPOracle::shrink_tight(const std::vector<int>& tight,
 }
 
 
-LPBasis EllipsoidLPOracle::compute_basis(const std::vector<int>& C) const {
+LPBasis EllipsoidLPOracle::compute_basis(const std::vector<int>& C,
+                                         const LPBasis* warm, const LPEval* evWarm) const {
     if (C.empty()) return LPBasis{{}, 0.0};
+    ELLPH_PERF_ADD(basis_calls, 1);
+    ELLPH_PERF_PHASE(timer, PerfPhase::Basis);
 
     // Solve on C
-    LPEval ev = evaluate(C);
+    LPEval ev = evaluate(C, warm, evWarm);
     // Tight set T := { j in C : |d_j - eps*| <= tol }
     std::vector<int> T;
     for (int t = 0; t < (int)C.size(); ++t) {
@@ -209,6 +455,13 @@ LPBasis EllipsoidLPOracle::compute_basis(const std::vector<int>& C) const {
     //         }
     //     }
     // }
+    // Complementary slackness: λ*_j > 0 only where d_j = eps*. The support is what the
+    // inner solver actually converged to, so it survives distances off by more than tol
+    for (int t = 0; t < (int)C.size(); ++t) {
+        if (ev.lambda.size() == (Eigen::Index)C.size() && ev.lambda[t] > kSupportTol &&
+            std::abs(ev.dists[t] - ev.eps_star) > P_.tight_tol)
+            T.push_back(C[t]);
+    }
     if (T.empty()) {
         int argmax = 0; double best = -1.0;
         for (int t = 0; t < (int)C.size(); ++t) {
@@ -220,7 +473,49 @@ LPBasis EllipsoidLPOracle::compute_basis(const std::vector<int>& C) const {
 
 
     auto Bidx = shrink_tight(T, C, ev);
-    // Recompute eps* on the basis itself (cheap, usually unchanged)
-    LPEval evB = evaluate(Bidx);
-    return LPBasis{Bidx, evB.eps_star};
+    // Recompute eps* on the basis itself (cheap, usually unchanged); λ* on C restricted
+    // to the basis is already close to optimal there
+    const LPBasis onC{C, ev.eps_star};
+    LPEval evB = evaluate(Bidx, &onC, &ev);
+
+    // A reduction that lost a basis element leaves elements of C outside the ball of B,
+    // beyond the solver's noise. Repair: add the farthest one and keep the support of the
+    // new solution, which raises f(B) each round, with |B| <= d+1 throughout.
+    Eigen::VectorXd diff(d_);
+    for (int round = 0; ; ++round) {
+        const LPBasis B{Bidx, evB.eps_star};
+        const double r = evB.eps_star + std::max(P_.tight_tol, kSupportTol * evB.eps_star);
+        int far = -1;
+        double far_d2 = r * r;
+        for (int t = 0; t < (int)C.size(); ++t) {
+            const double d2 = mahalanobis2_packed(C[t], evB.m, diff);
+            if (d2 > far_d2) { far_d2 = d2; far = t; }
+        }
+        if (far < 0) return B;
+        if (round == (int)C.size())
+            throw std::runtime_error("compute_basis: no basis of " + std::to_string(C.size()) +
+                                     " ellipsoids found");
+        ELLPH_PERF_ADD(basis_repairs, 1);
+        std::vector<int> grown = Bidx;
+        grown.push_back(C[far]);
+        const LPEval evG = evaluate(grown, &B, &evB);
+
+        // Support of λ* on grown, the d+1 largest weights if degenerate
+        std::vector<int> order(grown.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return evG.lambda[a] > evG.lambda[b]; });
+        Bidx.clear();
+        for (int t : order) {
+            if ((int)Bidx.size() == d_ + 1 || !(evG.lambda[t] > kSupportTol)) break;
+            Bidx.push_back(grown[t]);
+        }
+        if (Bidx.empty()) Bidx.push_back(grown[order[0]]);
+        std::sort(Bidx.begin(), Bidx.end());
+        const LPBasis onG{grown, evG.eps_star};
+        LPEval evNext = evaluate(Bidx, &onG, &evG);
+        if (!(evNext.eps_star > evB.eps_star)) // the solves disagree with the distances
+            throw std::runtime_error("compute_basis: basis repair made no progress on " +
+                                     std::to_string(C.size()) + " ellipsoids");
+        evB = std::move(evNext);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "Newton.hpp"
+#include "PerfCounters.hpp"
+#include "Simplex.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+template <class Obj>
+NewtonResult minimize_newton(Obj& obj, const Eigen::VectorXd& lambda0, const NewtonOptions& opt) {
+    using Vec = Eigen::VectorXd;
+    using Mat = Eigen::MatrixXd;
+    const int k = static_cast<int>(lambda0.size());
+
+    Vec lam = Simplex::project_to_simplex(lambda0);
+    Vec g(k);
+    Mat H(k, k);
+    double f = obj.value_grad_hess(lam, g, H);
+
+    std::vector<int> F; F.reserve(k);
+    Vec dir(k), cand(k);
+    int newton_steps = 0;
+
+    // Newton step along the projection arc α -> P(λ + α dir), α = 1, β, β^2, ...: every
+    // coordinate the step drives negative leaves the support at once, where the feasible
+    // line search below stops at the first one. Leaves the trial point in cand.
+    auto take_arc = [&]() {
+        for (double alpha = 1.0; alpha > 1e-16; alpha *= opt.armijo_beta) {
+            cand = Simplex::project_to_simplex(lam + alpha * dir);
+            const double f_new = obj.value(cand);
+            if (f_new < f && f_new <= f + opt.armijo_c * g.dot(cand - lam)) return true;
+        }
+        return false;
+    };
+
+    // Armijo line search along dir (projected-gradient direction unless use_dir),
+    // starting from the longest feasible step. Leaves the trial point in cand.
+    auto take_step = [&](bool use_dir) {
+        if (!use_dir) dir = Simplex::project_to_simplex(lam - g) - lam;
+        const double gTd = g.dot(dir);
+        if (!(gTd < 0.0)) return false;
+
+        // λ + α dir ≥ 0; the sum is preserved by construction
+        double amax = 1.0;
+        int blocking = -1;
+        for (int i = 0; i < k; ++i) {
+            if (dir[i] < 0.0 && lam[i] < -amax * dir[i]) { amax = lam[i] / -dir[i]; blocking = i; }
+        }
+
+        double alpha = amax;
+        while (alpha > 1e-16) {
+            cand = lam + alpha * dir;
+            if (alpha == amax && blocking >= 0) cand[blocking] = 0.0;
+            cand = cand.cwiseMax(0.0);
+            cand /= cand.sum();
+            const double f_new = obj.value(cand);
+            // Strict decrease too: near the optimum the Armijo slack drops below rounding
+            if (f_new < f && f_new <= f + opt.armijo_c * alpha * gTd) return true;
+            alpha *= opt.armijo_beta;
+        }
+        return false;
+    };
+
+    for (int it = 0; it < opt.max_iters; ++it) {
+        if (opt.cancel && opt.cancel->load(std::memory_order_relaxed))
+            return {lam, f, it, false, newton_steps};
+        // First-order stationarity on the simplex
+        if ((lam - Simplex::project_to_simplex(lam - g)).norm() < opt.tol * std::max(1.0, g.norm())) {
+            return {lam, f, it, true, newton_steps};
+        }
+
+        // Free face: the support, plus boundary coordinates whose gradient is below the
+        // multiplier estimate ν = mean of g over the support (they want to enter)
+        double nu = 0.0; int nsupp = 0;
+        for (int i = 0; i < k; ++i) if (lam[i] > opt.active_tol) { nu += g[i]; ++nsupp; }
+        nu /= std::max(1, nsupp);
+        F.clear();
+        for (int i = 0; i < k; ++i) if (lam[i] > opt.active_tol || g[i] < nu) F.push_back(i);
+
+        // Newton step on F with Δ_F = Z u, Z = [I_{p-1}; -1^T] spanning {1^T Δ_F = 0}.
+        // Boundary coordinates the step would push negative are dropped from F and the
+        // step recomputed, so the feasible step length stays positive.
+        auto newton_dir = [&]() {
+            while (F.size() >= 2) {
+                const int p = static_cast<int>(F.size());
+                const int last = F[p-1];
+                Mat Hr(p-1, p-1);
+                Vec gr(p-1);
+                for (int a = 0; a < p-1; ++a) {
+                    gr[a] = g[F[a]] - g[last];
+                    for (int b = 0; b < p-1; ++b)
+                        Hr(a,b) = H(F[a],F[b]) - H(F[a],last) - H(last,F[b]) + H(last,last);
+                }
+                const double shift = opt.reg * std::max(1.0, Hr.diagonal().cwiseAbs().maxCoeff());
+                Hr.diagonal().array() += shift;
+                Eigen::LLT<Mat> llt(Hr);
+                ELLPH_PERF_ADD(llt_factorizations, 1);
+                if (llt.info() != Eigen::Success) { // indefinite
+                    ELLPH_PERF_ADD(llt_failures, 1);
+                    return false;
+                }
+                const Vec u = -llt.solve(gr);
+                if (!u.allFinite()) return false;
+
+                dir.setZero();
+                double s = 0.0;
+                for (int a = 0; a < p-1; ++a) { dir[F[a]] = u[a]; s += u[a]; }
+                dir[last] = -s;
+
+                const auto before = F.size();
+                F.erase(std::remove_if(F.begin(), F.end(), [&](int i) {
+                    return lam[i] <= opt.active_tol && dir[i] < 0.0;
+                }), F.end());
+                if (F.size() == before) return g.dot(dir) < 0.0;
+            }
+            return false;
+        };
+
+        const bool newton = newton_dir();
+        if (newton && (take_arc() || take_step(true))) {
+            ++newton_steps;
+        } else if (!take_step(false)) {
+            // Neither the damped Newton nor the projected-gradient step decreases K:
+            // stationary up to rounding
+            return {lam, f, it, true, newton_steps};
+        }
+
+        lam.swap(cand);
+        f = obj.value_grad_hess(lam, g, H);
+    }
+    return {lam, f, opt.max_iters, false, newton_steps};
+}
+
+#define ELLPH_INSTANTIATE_NEWTON(D) \
+    template NewtonResult minimize_newton(KObjectiveT<D>&, const Eigen::VectorXd&, const NewtonOptions&);
+ELLPH_FOR_EACH_DIM(ELLPH_INSTANTIATE_NEWTON)
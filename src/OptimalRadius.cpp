@@ -1,40 +1,247 @@
 #include "OptimalRadius.hpp"
+#include "KFromEllipsoids.hpp"
+#include "PerfCounters.hpp"
 #include "Simplex.hpp"
+#include "ThreadPool.hpp"
+#include <atomic>
 #include <cmath>
+#include <exception>
+#include <limits>
+#include <stdexcept>
 
-EpsStar optimal_radius(KObjective& obj, SolverKind solver) {
-    const int k = obj.k();
-    auto lam0 = Simplex::uniform_start(k);
+namespace {
+
+// Racers of optimal_radius_portfolio when PortfolioOptions::pool is null: created on
+// first use and kept, so a race starts no threads
+WorkStealingPool& portfolio_pool() {
+    static WorkStealingPool pool(WorkStealingPool::Options{});
+    return pool;
+}
 
-    Eigen::VectorXd lam_star;
-    double fval;
+struct SolveOut {
+    Eigen::VectorXd lambda;
+    int iters = 0;
+    bool converged = false;
+};
+
+// One iterative solve with the settings optimal_radius uses for each kind
+template <int D>
+SolveOut run_solver(KObjectiveT<D>& obj, SolverKind solver, const Eigen::VectorXd* lambda0,
+                    const std::atomic<bool>* cancel) {
+    const int k = obj.k();
+    Eigen::VectorXd lam0;
+    // Cauchy-Simplex updates are multiplicative: the near-zero weights of a warm start
+    // (e.g. the padded entry of a new constraint) grow too slowly, and its step test stops
+    // there, so it always starts uniform
+    if (lambda0 && lambda0->size() == k && solver != SolverKind::Cauchy) {
+        lam0 = Simplex::project_to_simplex(*lambda0);
+    } else {
+        lam0 = Simplex::uniform_start(k);
+    }
 
+    SolveOut out;
     switch (solver) {
         case SolverKind::PGD: {
-            PGDOptions o; o.max_iters=2000; o.tol=1e-10;
+            PGDOptions o; o.max_iters=2000; o.tol=1e-10; o.cancel = cancel;
             auto res = minimize_pgd(obj, lam0, o);
-            lam_star = res.lambda; fval = res.fval; break;
+            out = {res.lambda, res.iters, res.converged}; break;
         }
         case SolverKind::Cauchy: {
-            CSOptions o; o.max_iters=4000; o.tol=1e-10;
+            CSOptions o; o.max_iters=4000; o.tol=1e-10; o.cancel = cancel;
             auto res = minimize_cauchy_simplex(obj, lam0, o);
-            lam_star = res.lambda; fval = res.fval; break;
+            out = {res.lambda, res.iters, res.converged}; break;
         }
         case SolverKind::SLSQP: {
-            NloptOptions o; o.max_evals=5000; o.rel_tol=1e-10; o.abs_tol=1e-12;
+            NloptOptions o; o.max_evals=5000; o.rel_tol=1e-10; o.abs_tol=1e-12; o.cancel = cancel;
             auto res = minimize_slsqp(obj, lam0, o);
-            lam_star = res.lambda; fval = res.fval; break;
+            out = {res.lambda, res.evals, res.status >= nlopt::SUCCESS && res.status <= nlopt::XTOL_REACHED};
+            break;
+        }
+        case SolverKind::Newton: {
+            // The projected arc moves many indices per step; the cap still grows with k
+            NewtonOptions o; o.max_iters=std::max(100, k); o.tol=1e-12; o.cancel = cancel;
+            auto res = minimize_newton(obj, lam0, o);
+            out = {res.lambda, res.iters, res.converged}; break;
         }
+        case SolverKind::Portfolio:
+            throw std::invalid_argument("run_solver: Portfolio is not a single solver");
     }
+    ELLPH_PERF_ADD(solver[static_cast<int>(solver)].solves, 1);
+    ELLPH_PERF_ADD(solver[static_cast<int>(solver)].iterations, out.iters);
+    ELLPH_PERF_ADD(solver[static_cast<int>(solver)].converged, out.converged ? 1 : 0);
+    return out;
+}
 
-    // Ensure internal state is consistent with lam_star (value_grad fills centroid + d2)
-    Eigen::VectorXd g;
-    g.resize(lam_star.size());
-    obj.value_grad(lam_star, g);
-    const auto& m = obj.centroid();
-    const auto& d2 = obj.mahalanobis_d2();
+// k = 2 (KObjectiveT::solve_pair): no iterations of the solver, no factorizations
+template <int D>
+EpsStar solve_pair(KObjectiveT<D>& obj, SolverKind solver) {
+    Eigen::VectorXd lam_star(2);
+    const int iters = obj.solve_pair(lam_star);
+    ELLPH_PERF_ADD(pair_solves, 1);
+    if (solver != SolverKind::Portfolio) {
+        ELLPH_PERF_ADD(solver[static_cast<int>(solver)].solves, 1);
+        ELLPH_PERF_ADD(solver[static_cast<int>(solver)].iterations, iters);
+        ELLPH_PERF_ADD(solver[static_cast<int>(solver)].converged, 1);
+    }
+    const auto d2 = obj.mahalanobis_d2();
     Eigen::VectorXd d = d2.array().sqrt();
+    return {d.maxCoeff(), lam_star, d, iters, true, d2.maxCoeff() - lam_star.dot(d2)};
+}
+
+// obj at lam (value_grad fills centroid + d2), as an EpsStar
+template <int D>
+EpsStar finish(KObjectiveT<D>& obj, Eigen::VectorXd lam, int iters, bool converged) {
+    Eigen::VectorXd g(lam.size());
+    obj.value_grad(lam, g);
+    const auto d2 = obj.mahalanobis_d2();
+    const double gap = d2.maxCoeff() - lam.dot(d2);
+    Eigen::VectorXd d = d2.array().sqrt();
+    const double eps_star = d.maxCoeff();
+    return {eps_star, std::move(lam), std::move(d), iters, converged, gap};
+}
+
+
+} // namespace
+
+template <int D>
+EpsStar optimal_radius(KObjectiveT<D>& obj, SolverKind solver, const Eigen::VectorXd* lambda0) {
+    if (obj.k() == 2) return solve_pair(obj, solver);
+    if (solver == SolverKind::Portfolio) return optimal_radius_portfolio(obj, PortfolioOptions{}, lambda0).est;
+    SolveOut out = run_solver(obj, solver, lambda0, nullptr);
+    EpsStar est = finish(obj, std::move(out.lambda), out.iters, out.converged);
+    // A warm start can leave the solver stuck on the wrong face: check and redo it cold
+    if (lambda0 && solver != SolverKind::Cauchy && !gap_within(est)) {
+        ELLPH_PERF_ADD(warm_retries, 1);
+        out = run_solver(obj, solver, nullptr, nullptr);
+        EpsStar cold = finish(obj, std::move(out.lambda), out.iters, out.converged);
+        cold.iters += est.iters;
+        if (cold.gap <= est.gap) return cold;
+        Eigen::VectorXd g(obj.k()); // the warm one was better after all: obj back at its λ*
+        obj.value_grad(est.lambda_star, g);
+    }
+    return est;
+}
+
+template <int D>
+PortfolioResult optimal_radius_portfolio(KObjectiveT<D>& obj, const PortfolioOptions& opt,
+                                         const Eigen::VectorXd* lambda0) {
+    if (opt.solvers.empty()) throw std::invalid_argument("optimal_radius_portfolio: no solvers");
+    for (SolverKind s : opt.solvers)
+        if (s == SolverKind::Portfolio) throw std::invalid_argument("optimal_radius_portfolio: nested Portfolio");
+    const int k = obj.k();
+    if (k == 2) return {solve_pair(obj, SolverKind::Portfolio), std::nullopt, 0.0};
+
+    struct Racer {
+        SolveOut out;
+        double gap = std::numeric_limits<double>::infinity();
+        PerfCounters perf;
+        std::exception_ptr error;
+    };
+    const int r = static_cast<int>(opt.solvers.size());
+    std::vector<Racer> racers(r);
+    std::atomic<bool> cancel{false};
+    std::atomic<int> winner{-1};
+
+    auto race = [&](int i) {
+        const perf::Scope scope;
+        Racer& R = racers[i];
+        try {
+            KObjectiveT<D> K(obj, nullptr);
+            R.out = run_solver(K, opt.solvers[i], lambda0, &cancel);
+            if (!cancel.load()) { // a cancelled run is discarded anyway
+                Eigen::VectorXd g(k);
+                K.value_grad(R.out.lambda, g);
+                const auto d2 = K.mahalanobis_d2();
+                const double top = d2.maxCoeff();
+                R.gap = top - R.out.lambda.dot(d2);
+                int none = -1;
+                if (R.gap <= opt.cert_tol * std::max(1.0, top) && winner.compare_exchange_strong(none, i))
+                    cancel.store(true);
+            }
+        } catch (...) {
+            R.error = std::current_exception();
+        }
+        R.perf = scope.delta();
+    };
+    const bool raced = WorkStealingPool::current_worker() < 0;
+    if (raced) {
+        WorkStealingPool& pool = opt.pool ? *opt.pool : portfolio_pool();
+        pool.parallel_for(0, r, race);
+        for (const Racer& R : racers) perf::absorb(R.perf);
+    } else {
+        // On a pool worker (e.g. inside optimal_radius_batch) racing would block the worker
+        // and oversubscribe the cores: run the solvers in turn, up to the first certified
+        for (int i = 0; i < r && winner.load() < 0; ++i) race(i); // counted in place
+    }
+
+    int w = winner.load();
+    bool certified = w >= 0;
+    if (!certified) { // nobody passed: the smallest gap among those that finished
+        for (int i = 0; i < r; ++i)
+            if (!racers[i].error && (w < 0 || racers[i].gap < racers[w].gap)) w = i;
+        if (w < 0) std::rethrow_exception(racers[0].error);
+    }
+    PortfolioStats& stats = opt.stats ? *opt.stats : portfolio_stats();
+    const std::optional<SolverKind> kind = certified ? std::optional(opt.solvers[w]) : std::nullopt;
+    if (opt.record && raced) stats.record(k, obj.d(), kind); // an in-turn run says nothing of speed
+
+    Racer& R = racers[w];
+    return {finish(obj, std::move(R.out.lambda), R.out.iters, R.out.converged && certified), kind, R.gap};
+}
+
+int PortfolioStats::k_bucket(int k) noexcept {
+    int b = 1;
+    while (b <= k / 2) b *= 2;
+    return b;
+}
+
+void PortfolioStats::record(int k, int d, std::optional<SolverKind> winner) {
+    const std::lock_guard<std::mutex> lock(mu_);
+    Bucket& b = buckets_[{k_bucket(k), d}];
+    ++b.races;
+    if (winner) ++b.wins[static_cast<int>(*winner)];
+    else ++b.uncertified;
+}
+
+PortfolioStats::Bucket PortfolioStats::bucket(int k, int d) const {
+    const std::lock_guard<std::mutex> lock(mu_);
+    const auto it = buckets_.find({k_bucket(k), d});
+    return it == buckets_.end() ? Bucket{} : it->second;
+}
+
+SolverKind PortfolioStats::best(int k, int d, SolverKind fallback) const {
+    const Bucket b = bucket(k, d);
+    int top = -1;
+    for (int s = 0; s < kNumSolverKinds; ++s)
+        if (b.wins[s] > 0 && (top < 0 || b.wins[s] > b.wins[top])) top = s;
+    return top < 0 ? fallback : static_cast<SolverKind>(top);
+}
+
+std::map<std::pair<int, int>, PortfolioStats::Bucket> PortfolioStats::snapshot() const {
+    const std::lock_guard<std::mutex> lock(mu_);
+    return buckets_;
+}
+
+void PortfolioStats::reset() {
+    const std::lock_guard<std::mutex> lock(mu_);
+    buckets_.clear();
+}
+
+PortfolioStats& portfolio_stats() {
+    static PortfolioStats stats;
+    return stats;
+}
+
+EpsStar optimal_radius(const std::vector<Ellipsoid>& Es, SolverKind solver, double epsilon) {
+    if (Es.empty()) throw std::invalid_argument("optimal_radius: empty ellipsoid set");
+    return dispatch_dim(Es[0].dim(), [&](auto dim) {
+        auto K = make_Kobjective_from_ellipsoids<decltype(dim)::value>(epsilon, Es);
+        return optimal_radius(K, solver);
+    });
+}
 
-    double eps_star = d.maxCoeff();
-    return {eps_star, lam_star, d};
-}
\ No newline at end of file
+#define ELLPH_INSTANTIATE_OPTIMAL_RADIUS(D) \
+    template EpsStar optimal_radius(KObjectiveT<D>&, SolverKind, const Eigen::VectorXd*); \
+    template PortfolioResult optimal_radius_portfolio(KObjectiveT<D>&, const PortfolioOptions&, \
+                                                      const Eigen::VectorXd*);
+ELLPH_FOR_EACH_DIM(ELLPH_INSTANTIATE_OPTIMAL_RADIUS)
@@ -0,0 +1,109 @@
+#include "OracleCache.hpp"
+#include <algorithm>
+
+static inline uint64_t fnv_mix(uint64_t h, uint64_t x){
+    h ^= x + 0x9e3779b97f4a7c15ULL;
+    h *= 1099511628211ULL;
+    return h;
+}
+
+// splitmix64 finalizer: spreads the FNV state over all bits (shard and bucket selection)
+static inline uint64_t avalanche(uint64_t h) {
+    h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27; h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+IndexKey::IndexKey(std::span<const int> idx)
+: size_(static_cast<int>(idx.size()))
+{
+    int* p;
+    if (size_ <= kInline) {
+        p = small_.data();
+    } else {
+        large_.resize(idx.size());
+        p = large_.data();
+    }
+    std::copy(idx.begin(), idx.end(), p);
+    std::sort(p, p + size_);
+
+    uint64_t h = 1469598103934665603ULL;
+    for (int i = 0; i < size_; ++i) h = fnv_mix(h, (uint64_t)p[i]);
+    hash_ = avalanche(h);
+}
+
+bool IndexKey::operator==(const IndexKey& o) const noexcept {
+    if (hash_ != o.hash_ || size_ != o.size_) return false;
+    const auto a = indices(), b = o.indices();
+    return std::equal(a.begin(), a.end(), b.begin());
+}
+
+OracleCache::OracleCache(Options opt)
+: shard_cap_(0), nshards_(std::max(1, opt.shards))
+{
+    shard_cap_ = opt.capacity == 0 ? 0 : (opt.capacity + nshards_ - 1) / nshards_;
+    shards_ = std::make_unique<Shard[]>(static_cast<size_t>(nshards_));
+}
+
+OracleCache::Shard& OracleCache::shard_for(const IndexKey& key) {
+    // High bits pick the shard; the unordered_map buckets use the low bits
+    return shards_[static_cast<size_t>((key.hash() >> 40) % static_cast<uint64_t>(nshards_))];
+}
+
+bool OracleCache::find(const IndexKey& key, CacheVal& out) {
+    if (shard_cap_ == 0) { misses_.fetch_add(1, std::memory_order_relaxed); return false; }
+    Shard& s = shard_for(key);
+    {
+        std::lock_guard<std::mutex> lk(s.mu);
+        auto it = s.map.find(key);
+        if (it != s.map.end()) {
+            s.lru.splice(s.lru.begin(), s.lru, it->second);
+            out = it->second->second;
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void OracleCache::insert(const IndexKey& key, const CacheVal& val) {
+    if (shard_cap_ == 0) return;
+    Shard& s = shard_for(key);
+    std::lock_guard<std::mutex> lk(s.mu);
+    auto it = s.map.find(key);
+    if (it != s.map.end()) {
+        // Another thread solved the same set concurrently; keep one copy, refresh recency
+        it->second->second = val;
+        s.lru.splice(s.lru.begin(), s.lru, it->second);
+        return;
+    }
+    if (s.lru.size() >= shard_cap_) {
+        s.map.erase(s.lru.back().first);
+        s.lru.pop_back();
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+    s.lru.emplace_front(key, val);
+    s.map.emplace(key, s.lru.begin());
+}
+
+OracleCacheStats OracleCache::stats() const {
+    OracleCacheStats st;
+    st.hits = hits_.load(std::memory_order_relaxed);
+    st.misses = misses_.load(std::memory_order_relaxed);
+    st.evictions = evictions_.load(std::memory_order_relaxed);
+    for (int i = 0; i < nshards_; ++i) {
+        std::lock_guard<std::mutex> lk(shards_[i].mu);
+        st.size += shards_[i].lru.size();
+    }
+    return st;
+}
+
+void OracleCache::clear() {
+    for (int i = 0; i < nshards_; ++i) {
+        std::lock_guard<std::mutex> lk(shards_[i].mu);
+        shards_[i].map.clear();
+        shards_[i].lru.clear();
+    }
+}
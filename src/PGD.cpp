@@ -2,26 +2,36 @@
 #include "Simplex.hpp"
 #include <cmath>
 
-PGDResult minimize_pgd(KObjective& obj, const Eigen::VectorXd& lambda0, const PGDOptions& opt) {
+template <class Obj>
+PGDResult minimize_pgd(Obj& obj, const Eigen::VectorXd& lambda0, const PGDOptions& opt) {
     using Vec = Eigen::VectorXd;
-    Vec lam = Simplex::project_to_simplex(lambda0);
-    Vec g; g.resize(lam.size());
+    const int k = static_cast<int>(lambda0.size());
+
+    // All iterates live in these buffers; the loop itself does not allocate
+    Simplex::Workspace ws;
+    ws.reserve(k);
+    Vec lam = lambda0;
+    Simplex::project_to_simplex(lam, ws);
+    Vec g(k), cand(k), dir(k), lam_new(k);
     double f = obj.value_grad(lam, g);
 
     for (int it = 0; it < opt.max_iters; ++it) {
+        if (opt.cancel && opt.cancel->load(std::memory_order_relaxed)) return {lam, f, it, false};
         // Feasible descent direction via projected step
-        const Vec z = lam - opt.step0 * g;
-        Vec cand = Simplex::project_to_simplex(z);
+        cand.noalias() = lam - opt.step0 * g;
+        Simplex::project_to_simplex(cand, ws);
+        dir.noalias() = cand - lam;
 
         // Armijo backtracking on the segment lam -> cand
         double alpha = 1.0;
-        const double gTd = g.dot(cand - lam);
-        Vec lam_new = cand;
+        const double gTd = g.dot(dir);
+        lam_new = cand;
         double f_new = obj.value(lam_new);
         while (f_new > f + opt.armijo_c * alpha * gTd) {
             if (alpha < 1e-12) break;
             alpha *= opt.armijo_beta;
-            lam_new = Simplex::project_to_simplex(lam + alpha * (cand - lam));
+            lam_new.noalias() = lam + alpha * dir;
+            Simplex::project_to_simplex(lam_new, ws);
             f_new = obj.value(lam_new);
         }
 
@@ -34,4 +44,8 @@ PGDResult minimize_pgd(KObjective& obj, const Eigen::VectorXd& lambda0, const PG
         f = obj.value_grad(lam, g);
     }
     return {lam, f, opt.max_iters, false};
-}
\ No newline at end of file
+}
+
+#define ELLPH_INSTANTIATE_PGD(D) \
+    template PGDResult minimize_pgd(KObjectiveT<D>&, const Eigen::VectorXd&, const PGDOptions&);
+ELLPH_FOR_EACH_DIM(ELLPH_INSTANTIATE_PGD)
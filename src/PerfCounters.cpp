@@ -0,0 +1,53 @@
+#include "PerfCounters.hpp"
+
+SolverPerf PerfCounters::solver_total() const noexcept {
+    SolverPerf t;
+    for (const auto& s : solver) {
+        t.solves += s.solves;
+        t.iterations += s.iterations;
+        t.converged += s.converged;
+    }
+    return t;
+}
+
+PerfCounters& PerfCounters::operator+=(const PerfCounters& o) noexcept {
+    objective_evals += o.objective_evals;
+    llt_factorizations += o.llt_factorizations;
+    llt_failures += o.llt_failures;
+    for (int s = 0; s < kNumSolverKinds; ++s) {
+        solver[s].solves += o.solver[s].solves;
+        solver[s].iterations += o.solver[s].iterations;
+        solver[s].converged += o.solver[s].converged;
+    }
+    pair_solves += o.pair_solves;
+    warm_retries += o.warm_retries;
+    cache_hits += o.cache_hits;
+    cache_misses += o.cache_misses;
+    basis_calls += o.basis_calls;
+    basis_repairs += o.basis_repairs;
+    float_tests += o.float_tests;
+    float_fallbacks += o.float_fallbacks;
+    for (int p = 0; p < kNumPerfPhases; ++p) phase_ms[p] += o.phase_ms[p];
+    return *this;
+}
+
+PerfCounters& PerfCounters::operator-=(const PerfCounters& o) noexcept {
+    objective_evals -= o.objective_evals;
+    llt_factorizations -= o.llt_factorizations;
+    llt_failures -= o.llt_failures;
+    for (int s = 0; s < kNumSolverKinds; ++s) {
+        solver[s].solves -= o.solver[s].solves;
+        solver[s].iterations -= o.solver[s].iterations;
+        solver[s].converged -= o.solver[s].converged;
+    }
+    pair_solves -= o.pair_solves;
+    warm_retries -= o.warm_retries;
+    cache_hits -= o.cache_hits;
+    cache_misses -= o.cache_misses;
+    basis_calls -= o.basis_calls;
+    basis_repairs -= o.basis_repairs;
+    float_tests -= o.float_tests;
+    float_fallbacks -= o.float_fallbacks;
+    for (int p = 0; p < kNumPerfPhases; ++p) phase_ms[p] -= o.phase_ms[p];
+    return *this;
+}
@@ -1,11 +1,14 @@
 #include "RandomEllipsoidGenerator.hpp"
+#include "ThreadPool.hpp"
 #include <Eigen/QR>
 #include <Eigen/Cholesky>
+#include <algorithm>
+#include <memory>
 #include <stdexcept>
 #include <cmath>
 
 RandomEllipsoidGenerator::RandomEllipsoidGenerator(Options opts)
-    : opts_(std::move(opts)), rng_(opts_.seed)
+    : opts_(std::move(opts))
 {
     if (opts_.n <= 0 || opts_.d <= 0) {
         throw std::invalid_argument("RandomEllipsoidGenerator: n and d must be positive.");
@@ -25,56 +28,68 @@ RandomEllipsoidGenerator::RandomEllipsoidGenerator(Options opts)
     }
 }
 
-std::vector<Ellipsoid> RandomEllipsoidGenerator::generate() {
-    std::vector<Ellipsoid> out;
-    out.reserve(static_cast<size_t>(opts_.n));
-
-    for (int i = 0; i < opts_.n; ++i) {
-        Vec c = sample_center();
+template <class F>
+void RandomEllipsoidGenerator::for_each_index(F&& f) const {
+    if (opts_.threads == 1) {
+        for (int i = 0; i < opts_.n; ++i) f(i);
+        return;
+    }
+    WorkStealingPool pool(WorkStealingPool::Options{opts_.threads});
+    pool.parallel_for(0, opts_.n, f, std::max(1, opts_.n / (8 * pool.size())));
+}
 
-        // Build SPD as covariance by default; if user wants precision at storage time,
-        // we invert once (dimension is usually moderate; for large d you could switch to lazy).
-        Mat cov;
-        if (opts_.spd_mode == SPDMode::LogUniformSpectrum) {
-            cov = spd_from_loguniform_spectrum();
-        } else {
-            cov = spd_from_wishart();
-        }
+RandomEllipsoidGenerator::Draw RandomEllipsoidGenerator::draw(int i, bool want_cov, bool want_prec) const {
+    Philox4x32 rng(opts_.seed, static_cast<uint64_t>(i));
+    Draw out;
+    out.center = sample_center(rng);
+    if (opts_.spd_mode == SPDMode::LogUniformSpectrum) {
+        spd_from_loguniform_spectrum(rng, out, want_cov, want_prec);
+    } else {
+        spd_from_wishart(rng, out, want_cov, want_prec);
+    }
+    return out;
+}
 
-        if (opts_.store_covariance) {
-            out.emplace_back(std::move(c), cov, std::nullopt, opts_.radius);
+std::vector<Ellipsoid> RandomEllipsoidGenerator::generate() {
+    std::vector<Ellipsoid> out(static_cast<size_t>(opts_.n));
+    const bool cov = opts_.store_covariance;
+    for_each_index([&](int i) {
+        Draw D = draw(i, cov, !cov);
+        if (cov) {
+            out[i] = Ellipsoid(std::move(D.center), std::move(D.cov), std::nullopt, opts_.radius);
         } else {
             // store precision, not covariance
-            Eigen::LLT<Mat> llt(cov);
-            if (llt.info() != Eigen::Success) {
-                throw std::runtime_error("Generated covariance is not SPD (LLT failed).");
-            }
-            Mat L = llt.matrixL();
-            Mat Linv = L.inverse();
-            Mat prec = Linv.transpose() * Linv; // Σ^{-1}
-            out.emplace_back(std::move(c), std::nullopt, prec, opts_.radius);
+            out[i] = Ellipsoid(std::move(D.center), std::nullopt, std::move(D.prec), opts_.radius);
         }
-    }
+    });
     return out;
 }
 
-RandomEllipsoidGenerator::Vec RandomEllipsoidGenerator::sample_center() {
+EllipsoidSet RandomEllipsoidGenerator::generate_set() {
+    EllipsoidSet out(opts_.d, opts_.n);
+    out.resize(opts_.n);
+    for_each_index([&](int i) {
+        const Draw D = draw(i, false, true);
+        out.assign(i, D.center, D.prec, opts_.radius); // factors the precision in the arena
+    });
+    return out;
+}
+
+RandomEllipsoidGenerator::Vec RandomEllipsoidGenerator::sample_center(Philox4x32& rng) const {
     Vec v(opts_.d);
     if (opts_.center_mode == CenterMode::UniformHypercube) {
-        std::uniform_real_distribution<double> U(-opts_.center_scale, opts_.center_scale);
-        for (int j = 0; j < opts_.d; ++j) v[j] = U(rng_);
+        for (int j = 0; j < opts_.d; ++j) v[j] = rng.uniform(-opts_.center_scale, opts_.center_scale);
     } else {
-        std::normal_distribution<double> N(0.0, opts_.center_std);
-        for (int j = 0; j < opts_.d; ++j) v[j] = N(rng_);
+        for (int j = 0; j < opts_.d; ++j) v[j] = opts_.center_std * rng.normal();
     }
     return v;
 }
 
-RandomEllipsoidGenerator::Mat RandomEllipsoidGenerator::random_orthonormal(int d) {
-    Mat G = Mat::NullaryExpr(d, d, [this](){ std::normal_distribution<double> N(0.0, 1.0); return N(rng_); });
-    Eigen::HouseholderQR<Mat> qr(G);
-    Mat Q = qr.householderQ() * Mat::Identity(d, d);
-    return Q; // columns orthonormal
+RandomEllipsoidGenerator::Mat RandomEllipsoidGenerator::random_orthonormal(Philox4x32& rng, int d) const {
+    Mat G(d, d);
+    for (Eigen::Index t = 0; t < G.size(); ++t) G.data()[t] = rng.normal();
+    Eigen::HouseholderQR<Eigen::Ref<Mat>> qr(G); // in place
+    return qr.householderQ() * Mat::Identity(d, d); // columns orthonormal
 }
 
 RandomEllipsoidGenerator::Mat RandomEllipsoidGenerator::make_cov_from_spectrum(const Mat& Q, const Vec& evals) {
@@ -82,44 +97,48 @@ RandomEllipsoidGenerator::Mat RandomEllipsoidGenerator::make_cov_from_spectrum(c
     if ((evals.array() <= 0.0).any()) {
         throw std::invalid_argument("Eigenvalues must be strictly positive.");
     }
-    Mat D = evals.asDiagonal();
-    return Q * D * Q.transpose();
+    // (Q diag(√λ)) (Q diag(√λ))^T: one GEMM, symmetric by construction
+    const Mat B = Q * evals.cwiseSqrt().asDiagonal();
+    return B * B.transpose();
 }
 
-RandomEllipsoidGenerator::Mat RandomEllipsoidGenerator::spd_from_loguniform_spectrum() {
+void RandomEllipsoidGenerator::spd_from_loguniform_spectrum(Philox4x32& rng, Draw& out,
+                                                            bool want_cov, bool want_prec) const {
     const int d = opts_.d;
-    Mat Q = random_orthonormal(d);
+    const Mat Q = random_orthonormal(rng, d);
 
     // sample λ ~ LogUniform([lambda_min, lambda_max])
-    std::uniform_real_distribution<double> U(std::log(opts_.lambda_min), std::log(opts_.lambda_max));
+    const double a = std::log(opts_.lambda_min), b = std::log(opts_.lambda_max);
     Vec evals(d);
-    for (int i = 0; i < d; ++i) evals[i] = std::exp(U(rng_));
-    // cov = Q diag(λ) Q^T
-    return make_cov_from_spectrum(Q, evals);
+    for (int i = 0; i < d; ++i) evals[i] = std::exp(rng.uniform(a, b));
+    // cov = Q diag(λ) Q^T, and its inverse Q diag(1/λ) Q^T from the same spectrum
+    if (want_cov) out.cov = make_cov_from_spectrum(Q, evals);
+    if (want_prec) out.prec = make_cov_from_spectrum(Q, evals.cwiseInverse());
 }
 
-RandomEllipsoidGenerator::Mat RandomEllipsoidGenerator::spd_from_wishart() {
+void RandomEllipsoidGenerator::spd_from_wishart(Philox4x32& rng, Draw& out,
+                                                bool want_cov, bool want_prec) const {
     // Wishart W_d(df, I): cov = (1/df) * G G^T with G ~ N(0,1)^{d x df}
     // Scaling by 1/df keeps eigenvalues centered near 1 as df grows.
     const int d = opts_.d;
     const int df = opts_.wishart_df;
-    Mat G = Mat::NullaryExpr(d, df, [this](){ std::normal_distribution<double> N(0.0, 1.0); return N(rng_); });
+    Mat G(d, df);
+    for (Eigen::Index t = 0; t < G.size(); ++t) G.data()[t] = rng.normal();
     Mat S = (G * G.transpose()) / static_cast<double>(df);
 
-    // Small regularization for numerical stability (optional; comment if you prefer pure Wishart)
-    // S += 1e-12 * Mat::Identity(d, d);
-
     Eigen::LLT<Mat> llt(S);
     if (llt.info() != Eigen::Success) {
         // In the extremely rare case numerical SPD is lost, nudge the diagonal
-        Mat I = Mat::Identity(d, d);
-        double eps = 1e-10;
-        Mat Sreg = S + eps * I;
-        Eigen::LLT<Mat> llt2(Sreg);
-        if (llt2.info() != Eigen::Success) {
+        S.diagonal().array() += 1e-10;
+        llt.compute(S);
+        if (llt.info() != Eigen::Success) {
             throw std::runtime_error("Wishart draw failed to be SPD even after regularization.");
         }
-        return Sreg;
     }
-    return S;
-}
\ No newline at end of file
+    if (want_prec) {
+        // Σ^{-1} = L^{-T} L^{-1}, by a triangular solve against I
+        const Mat Linv = llt.matrixL().solve(Mat::Identity(d, d));
+        out.prec = Linv.transpose() * Linv;
+    }
+    if (want_cov) out.cov = std::move(S);
+}
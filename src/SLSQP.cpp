@@ -3,8 +3,18 @@
 #include <stdexcept>
 
 namespace {
+template <class Obj>
+struct Callback {
+    Obj* obj;
+    nlopt::opt* opti;
+    const std::atomic<bool>* cancel;
+};
+
+template <class Obj>
 double wrapper(unsigned n, const double* x, double* grad, void* data) {
-    KObjective* obj = static_cast<KObjective*>(data);
+    const auto* cb = static_cast<Callback<Obj>*>(data);
+    if (cb->cancel && cb->cancel->load(std::memory_order_relaxed)) cb->opti->force_stop();
+    Obj* obj = cb->obj;
     Eigen::Map<const Eigen::VectorXd> lam(x, n);
     if (grad) {
         Eigen::Map<Eigen::VectorXd> g(grad, n);
@@ -15,7 +25,8 @@ double wrapper(unsigned n, const double* x, double* grad, void* data) {
 }
 }
 
-NloptResult minimize_slsqp(KObjective& obj, const Eigen::VectorXd& lambda0, const NloptOptions& opt) {
+template <class Obj>
+NloptResult minimize_slsqp(Obj& obj, const Eigen::VectorXd& lambda0, const NloptOptions& opt) {
     const int k = static_cast<int>(lambda0.size());
     nlopt::opt opti(nlopt::LD_SLSQP, k);
 
@@ -35,7 +46,8 @@ NloptResult minimize_slsqp(KObjective& obj, const Eigen::VectorXd& lambda0, cons
         nullptr, std::vector<double>{1e-10}
     );
 
-    opti.set_min_objective(wrapper, &obj);
+    Callback<Obj> cb{&obj, &opti, opt.cancel};
+    opti.set_min_objective(wrapper<Obj>, &cb);
     opti.set_maxeval(opt.max_evals);
     opti.set_xtol_rel(opt.rel_tol);
     opti.set_xtol_abs(opt.abs_tol);
@@ -44,10 +56,19 @@ NloptResult minimize_slsqp(KObjective& obj, const Eigen::VectorXd& lambda0, cons
     Eigen::VectorXd lam0 = Simplex::project_to_simplex(lambda0);
     for (int i=0;i<k;++i) x[i] = lam0[i];
 
-    double minf;
-    nlopt::result status = opti.optimize(x, minf);
+    double minf = 0.0;
+    nlopt::result status;
+    try {
+        status = opti.optimize(x, minf);
+    } catch (const nlopt::forced_stop&) { // cancelled: x holds the last iterate
+        status = nlopt::FORCED_STOP;
+    }
 
     Eigen::VectorXd lam(k);
     for (int i=0;i<k;++i) lam[i] = x[i];
-    return {lam, minf, status};
-}
\ No newline at end of file
+    return {lam, minf, status, opti.get_numevals()};
+}
+
+#define ELLPH_INSTANTIATE_SLSQP(D) \
+    template NloptResult minimize_slsqp(KObjectiveT<D>&, const Eigen::VectorXd&, const NloptOptions&);
+ELLPH_FOR_EACH_DIM(ELLPH_INSTANTIATE_SLSQP)
@@ -1,26 +1,69 @@
 #include "Simplex.hpp"
 #include <algorithm>
+#include <functional>
 #include <vector>
 
+namespace {
+constexpr int kSortBelow = 128; // crossover measured with microbench
+}
+
 Eigen::VectorXd Simplex::project_to_simplex(const Eigen::VectorXd& z) {
-    // Condat (2016)-style O(k log k)
+    Workspace ws;
+    Eigen::VectorXd x = z;
+    project_to_simplex(x, ws);
+    return x;
+}
+
+void Simplex::project_to_simplex(Eigen::Ref<Eigen::VectorXd> z, Workspace& ws) {
+    // Randomized-pivot threshold search (Michelot / Duchi et al. 2008), expected O(k):
+    // find θ with sum_i max(z_i - θ, 0) = 1 without sorting
     const int k = static_cast<int>(z.size());
-    std::vector<double> u(k);
+    if (k == 0) return;
+    ws.reserve(k);
+    double* u = ws.buf.data();
     for (int i = 0; i < k; ++i) u[i] = z[i];
-    std::sort(u.begin(), u.end(), std::greater<double>());
-
-    double css = 0.0;
-    double theta = 0.0;
-    for (int i = 0; i < k; ++i) {
-        css += u[i];
-        const double t = (css - 1.0) / (i + 1);
-        if (i == k-1 || u[i+1] <= t) { theta = t; break; }
+
+    if (k <= kSortBelow) {
+        // Small k: sorting the scratch copy beats the pivot loop's overhead
+        std::sort(u, u + k, std::greater<double>());
+        double css = 0.0, theta = 0.0;
+        for (int i = 0; i < k; ++i) {
+            css += u[i];
+            const double t = (css - 1.0) / (i + 1);
+            if (i == k-1 || u[i+1] <= t) { theta = t; break; }
+        }
+        for (int i = 0; i < k; ++i) z[i] = std::max(z[i] - theta, 0.0);
+        return;
     }
-    Eigen::VectorXd x = z.array() - theta;
-    for (int i = 0; i < k; ++i) if (x[i] < 0.0) x[i] = 0.0;
-    return x;
+
+    double s = 0.0; // sum of the elements known to be in the support
+    int rho = 0;    // their count
+    int lo = 0, hi = k;
+    while (lo < hi) {
+        ws.rng ^= ws.rng << 13; ws.rng ^= ws.rng >> 7; ws.rng ^= ws.rng << 17;
+        std::swap(u[lo], u[lo + static_cast<int>(ws.rng % static_cast<std::uint64_t>(hi - lo))]);
+        const double pv = u[lo];
+
+        // [lo, mid): pivot and everything >= it
+        double* mid = std::partition(u + lo + 1, u + hi, [pv](double x) { return x >= pv; });
+        const int m = static_cast<int>(mid - u);
+        double ds = 0.0;
+        for (int i = lo; i < m; ++i) ds += u[i];
+        const int drho = m - lo;
+
+        if ((s + ds) - (rho + drho) * pv < 1.0) {
+            // pivot is in the support: keep G, continue on the smaller elements
+            s += ds; rho += drho; lo = m;
+        } else {
+            // threshold lies above the pivot: continue on G without it
+            lo = lo + 1; hi = m;
+        }
+    }
+
+    const double theta = (s - 1.0) / rho;
+    for (int i = 0; i < k; ++i) z[i] = std::max(z[i] - theta, 0.0);
 }
 
 Eigen::VectorXd Simplex::uniform_start(int k) {
     return Eigen::VectorXd::Constant(k, 1.0 / double(k));
-}
\ No newline at end of file
+}
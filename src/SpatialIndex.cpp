@@ -0,0 +1,135 @@
+#include "SpatialIndex.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+// Relative slack on the eigenvalue bounds: far above the rounding in computed eigenvalues
+// (~u·λ_max) and in the squared distances of both the bounds and the exact test (~d·u)
+static constexpr double kBoundSlack = 1e-10;
+
+SpatialIndex::SpatialIndex(const double* centers, size_t stride, int n, int d,
+                           std::vector<double> lmin, std::vector<double> lmax)
+: n_(n), d_(d) {
+    if (n <= 0 || d <= 0) throw std::invalid_argument("SpatialIndex: empty set");
+    if (static_cast<int>(lmin.size()) != n || static_cast<int>(lmax.size()) != n)
+        throw std::invalid_argument("SpatialIndex: eigenvalue bounds must have n entries");
+
+    // Build over the caller's centers, then store everything in leaf order
+    centers_ = Eigen::Map<const Eigen::MatrixXd, 0, Eigen::OuterStride<>>(
+        centers, d, n, Eigen::OuterStride<>(static_cast<Eigen::Index>(stride)));
+    lmin_.resize(n);
+    lmax_.resize(n);
+    for (int i = 0; i < n; ++i) {
+        lmin_[i] = std::max(0.0, lmin[i] - kBoundSlack * lmax[i]);
+        lmax_[i] = lmax[i] * (1.0 + kBoundSlack);
+    }
+    id_.resize(n);
+    std::iota(id_.begin(), id_.end(), 0);
+    nodes_.reserve(2 * (n / kLeafSize + 1));
+    build(0, n);
+
+    Eigen::MatrixXd c(d, n);
+    std::vector<double> lo(n), hi(n);
+    for (int p = 0; p < n; ++p) {
+        c.col(p) = centers_.col(id_[p]);
+        lo[p] = lmin_[id_[p]];
+        hi[p] = lmax_[id_[p]];
+    }
+    centers_ = std::move(c);
+    lmin_ = std::move(lo);
+    lmax_ = std::move(hi);
+}
+
+int SpatialIndex::build(int begin, int end) {
+    // Box and bounds of the range (centers_ / lmin_ / lmax_ are still in input order)
+    const int j = static_cast<int>(nodes_.size());
+    nodes_.push_back(Node{begin, end});
+    box_.resize(box_.size() + 2 * static_cast<size_t>(d_));
+    double* lo = box_.data() + 2 * static_cast<size_t>(d_) * j;
+    double* hi = lo + d_;
+    std::fill(lo, lo + d_, std::numeric_limits<double>::infinity());
+    std::fill(hi, hi + d_, -std::numeric_limits<double>::infinity());
+    double lmin = std::numeric_limits<double>::infinity(), lmax = 0.0;
+    for (int p = begin; p < end; ++p) {
+        const int i = id_[p];
+        for (int k = 0; k < d_; ++k) {
+            lo[k] = std::min(lo[k], centers_(k, i));
+            hi[k] = std::max(hi[k], centers_(k, i));
+        }
+        lmin = std::min(lmin, lmin_[i]);
+        lmax = std::max(lmax, lmax_[i]);
+    }
+    nodes_[j].lmin = lmin;
+    nodes_[j].lmax = lmax;
+    if (end - begin <= kLeafSize) return j;
+
+    // Median split along the widest side
+    int axis = 0;
+    for (int k = 1; k < d_; ++k)
+        if (hi[k] - lo[k] > hi[axis] - lo[axis]) axis = k;
+    const int mid = begin + (end - begin) / 2;
+    std::nth_element(id_.begin() + begin, id_.begin() + mid, id_.begin() + end,
+                     [&](int a, int b) { return centers_(axis, a) < centers_(axis, b); });
+    const int left = build(begin, mid);
+    const int right = build(mid, end);
+    nodes_[j].left = left;
+    nodes_[j].right = right;
+    return j;
+}
+
+void SpatialIndex::query(const Eigen::VectorXd& m, double r2, std::vector<int>& sure,
+                         std::vector<int>& ambiguous, Stats* stats) const {
+    if (m.size() != d_) throw std::invalid_argument("SpatialIndex::query: dimension mismatch");
+    Stats st;
+    std::vector<int> stack{0};
+    while (!stack.empty()) {
+        const Node& nd = nodes_[stack.back()];
+        const double* lo = box_.data() + 2 * static_cast<size_t>(d_) * stack.back();
+        const double* hi = lo + d_;
+        stack.pop_back();
+        ++st.nodes_visited;
+
+        // Nearest and farthest squared distance from m to the box
+        double near = 0.0, far = 0.0;
+        for (int k = 0; k < d_; ++k) {
+            const double a = lo[k] - m[k], b = m[k] - hi[k];
+            const double g = std::max({a, b, 0.0});
+            const double f = std::max(std::abs(a), std::abs(b));
+            near += g * g;
+            far += f * f;
+        }
+        if (nd.lmin * near > r2) { // every center below is far: all violate
+            for (int p = nd.begin; p < nd.end; ++p) sure.push_back(id_[p]);
+            st.settled += nd.end - nd.begin;
+            continue;
+        }
+        if (nd.lmax * far <= r2) { // every center below is close: none violates
+            st.settled += nd.end - nd.begin;
+            continue;
+        }
+        if (nd.left >= 0) {
+            stack.push_back(nd.right);
+            stack.push_back(nd.left);
+            continue;
+        }
+        for (int p = nd.begin; p < nd.end; ++p) {
+            const double e = (centers_.col(p) - m).squaredNorm();
+            if (lmin_[p] * e > r2) {
+                sure.push_back(id_[p]);
+                ++st.settled;
+            } else if (lmax_[p] * e > r2) {
+                ambiguous.push_back(id_[p]);
+                ++st.ambiguous;
+            } else {
+                ++st.settled;
+            }
+        }
+    }
+    if (stats) {
+        stats->nodes_visited += st.nodes_visited;
+        stats->settled += st.settled;
+        stats->ambiguous += st.ambiguous;
+    }
+}
@@ -0,0 +1,134 @@
+#include "ThreadPool.hpp"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+thread_local int tl_worker = -1;
+
+void pin_to_core(int w) {
+#if defined(__linux__)
+    const unsigned ncores = std::max(1u, std::thread::hardware_concurrency());
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(static_cast<int>(static_cast<unsigned>(w) % ncores), &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set); // best effort
+#else
+    (void)w; // no portable affinity API (e.g. macOS); run unpinned
+#endif
+}
+}
+
+WorkStealingPool::WorkStealingPool(Options opt)
+{
+    int n = opt.threads;
+    if (n <= 0) n = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    queues_ = std::vector<Queue>(static_cast<size_t>(n));
+    workers_.reserve(static_cast<size_t>(n));
+    for (int w = 0; w < n; ++w) {
+        workers_.emplace_back([this, w, pin = opt.pin_threads]() { worker_loop(w, pin); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+int WorkStealingPool::current_worker() noexcept { return tl_worker; }
+
+void WorkStealingPool::submit(std::function<void()> task) {
+    // A worker submitting from inside a task keeps the work local; others spread round-robin
+    const int nq = static_cast<int>(queues_.size());
+    const int w = (tl_worker >= 0 && tl_worker < nq)
+                      ? tl_worker
+                      : static_cast<int>(next_.fetch_add(1, std::memory_order_relaxed) % nq);
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lk(queues_[w].mu);
+        queues_[w].tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        queued_.fetch_add(1, std::memory_order_release);
+    }
+    work_cv_.notify_one();
+}
+
+bool WorkStealingPool::try_pop(int w, std::function<void()>& task) {
+    const int nq = static_cast<int>(queues_.size());
+    {   // own deque, newest first (cache-warm)
+        std::lock_guard<std::mutex> lk(queues_[w].mu);
+        if (!queues_[w].tasks.empty()) {
+            task = std::move(queues_[w].tasks.back());
+            queues_[w].tasks.pop_back();
+            return true;
+        }
+    }
+    for (int s = 1; s < nq; ++s) { // steal oldest from the others
+        Queue& q = queues_[(w + s) % nq];
+        std::lock_guard<std::mutex> lk(q.mu);
+        if (!q.tasks.empty()) {
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::worker_loop(int w, bool pin) {
+    tl_worker = w;
+    if (pin) pin_to_core(w);
+
+    std::function<void()> task;
+    while (true) {
+        if (try_pop(w, task)) {
+            queued_.fetch_sub(1, std::memory_order_acq_rel);
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard<std::mutex> lk(mu_);
+                if (!error_) error_ = std::current_exception();
+            }
+            task = nullptr;
+            if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lk(mu_);
+                idle_cv_.notify_all();
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> lk(mu_);
+        work_cv_.wait(lk, [this]() { return stop_ || queued_.load(std::memory_order_acquire) > 0; });
+        if (stop_ && queued_.load(std::memory_order_acquire) == 0) return;
+    }
+}
+
+void WorkStealingPool::wait_idle() {
+    std::unique_lock<std::mutex> lk(mu_);
+    idle_cv_.wait(lk, [this]() { return pending_.load(std::memory_order_acquire) == 0; });
+    if (error_) {
+        std::exception_ptr e = error_;
+        error_ = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+void WorkStealingPool::Group::finish(std::exception_ptr e) noexcept {
+    // Under the lock: once left reaches 0 the waiter may return and destroy the group
+    std::lock_guard<std::mutex> lk(mu);
+    if (e && !error) error = std::move(e);
+    if (--left == 0) cv.notify_all();
+}
+
+void WorkStealingPool::Group::wait() {
+    std::unique_lock<std::mutex> lk(mu);
+    cv.wait(lk, [this]() { return left == 0; });
+    if (error) std::rethrow_exception(error);
+}